@@ -1,13 +1,24 @@
 #include <benchmark/benchmark.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cvm/adaptive.hpp>
+#include <cvm/concurrent.hpp>
 #include <cvm/cvm_knuth.hpp>
 #include <cvm/cvm_naive.hpp>
+#include <cvm/grouped.hpp>
+#include <cvm/hashed.hpp>
+#include <cvm/ingest.hpp>
+#include <cvm/parallel.hpp>
+#include <cvm/windowed.hpp>
 #include <iostream>
+#include <mutex>
 #include <random>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -49,6 +60,33 @@ template<class T>
     return arr;
 }
 
+// Erzeugt N zufällige Zeichenketten der Form "user-<Zahl>" mit Zahlen aus [0, N), also mit Wiederholungen.
+// Mit 20 Ziffern sind die Zeichenketten länger als der Small-String-Puffer und liegen auf dem Heap, wie typische Schlüssel.
+[[nodiscard]] inline auto random_strings(std::size_t N) noexcept -> std::vector<std::string>
+{
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<std::uint64_t> dist(0, N > 0 ? N - 1 : 0);
+
+    std::vector<std::string> arr(N);
+    for(auto& elem : arr) {
+        auto digits = std::to_string(dist(gen));
+        elem = "user-" + std::string(20 - digits.size(), '0') + digits;
+    }
+
+    return arr;
+}
+
+// Erzeugt die Eingabe eines Benchmarks: Ganzzahlen über random_vec, Zeichenketten über random_strings.
+template<class T>
+[[nodiscard]] inline auto random_input(std::size_t N) noexcept -> std::vector<T>
+{
+    if constexpr(std::is_same_v<T, std::string>) {
+        return random_strings(N);
+    } else {
+        return random_vec<T>(N);
+    }
+}
+
 // Template-Funktion zur Durchführung des naiven CVM-Benchmarks.
 template<class T>
 inline static auto naive(benchmark::State& state)
@@ -75,7 +113,7 @@ inline static auto naive(benchmark::State& state)
         state.PauseTiming();
 
         // Generiert einen zufälligen Vektor der Größe N.
-        auto vec = random_vec<T>(N);
+        auto vec = random_input<T>(N);
 
         // Setzt die Zeitmessung fort.
         state.ResumeTiming();
@@ -89,7 +127,9 @@ inline static auto naive(benchmark::State& state)
 }
 
 // Template-Funktion zur Durchführung des Knuth CVM-Benchmarks.
-template<class T>
+// Buffer bestimmt den Container des Puffers: Treap mit Zeigern (SlabTreap), Treap mit 32-Bit-Indizes (IndexTreap)
+// oder Max-Heap im Array mit Hash-Index (IndexedHeap).
+template<class T, template<class, class> class Buffer = cvm::SlabTreap>
 inline static auto knuth(benchmark::State& state)
 {
 
@@ -105,20 +145,408 @@ inline static auto knuth(benchmark::State& state)
         state.PauseTiming();
 
         // Generiert einen zufälligen Vektor der Größe N.
-        auto vec = random_vec<T>(N);
+        auto vec = random_input<T>(N);
 
         // Setzt die Zeitmessung fort, um den eigentlichen Algorithmus, den wir messen möchten, zu erfassen.
         state.ResumeTiming();
 
         // Führt den knuth_cvm-Algorithmus aus dem cvm-Namensraum aus und speichert das Ergebnis.
         // Dies ist der eigentliche zu benchmarkende Code.
-        auto result = cvm::knuth_cvm(std::begin(vec), std::end(vec), s);
+        auto result = cvm::knuth_cvm<Buffer>(std::begin(vec), std::end(vec), s);
 
         // Instruiert die Benchmarking-Bibliothek, das Ergebnis `result` nicht zu optimieren.
         benchmark::DoNotOptimize(result);
     }
 }
 
+// Template-Funktion, die pro Element den fusionierten Schritt Treap::cvm_update mit der ursprünglichen
+// Folge aus delete_elem, top, pop und insert vergleicht. Die Durchsatzangabe (items_per_second) zeigt den Gewinn pro Element.
+template<class T, bool Fused>
+inline static auto knuth_step(benchmark::State& state)
+{
+    // Extrahiert die Länge des Streams und die Größe des Treaps.
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+
+    using TreapType = cvm::Treap<T, double>;
+
+    for(auto _ : state) {
+        // Stream und Treap werden außerhalb der Zeitmessung angelegt.
+        state.PauseTiming();
+        auto vec = random_vec<T>(N);
+        TreapType B(s + 1);
+        double p = 1;
+        state.ResumeTiming();
+
+        for(const auto& x : vec) {
+            const auto u = TreapType::generate_prio();
+
+            if constexpr(Fused) {
+                // Ein einziger Abstieg durch den Treap.
+                p = B.cvm_update(x, u, p, s);
+            } else {
+                // Bis zu drei Abstiege durch den Treap.
+                B.delete_elem(x);
+                if(u >= p) {
+                    continue;
+                }
+                if(B.size() < s) {
+                    B.insert(x, u);
+                    continue;
+                }
+                const auto [a_prime, u_prime] = B.top().value();
+                if(u >= u_prime) {
+                    p = u;
+                } else {
+                    B.pop();
+                    B.insert(x, u);
+                    p = u_prime;
+                }
+            }
+        }
+
+        // Instruiert die Benchmarking-Bibliothek, das Ergebnis nicht zu optimieren.
+        benchmark::DoNotOptimize(B.size() / p);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Vergleicht KnuthSketch::add pro Element mit add_batch, das die Suchpfade blockweise vorab lädt.
+// Interessant für große Puffer (s >= 10^5), die nicht mehr in den L2-Cache passen.
+template<class T, template<class, class> class Buffer, bool Batch>
+inline static auto knuth_block(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_vec<T>(N);
+        cvm::KnuthSketch<T, Buffer> sketch(s);
+        sketch.reserve(N);
+        state.ResumeTiming();
+
+        if constexpr(Batch) {
+            sketch.add_batch(vec);
+        } else {
+            for(const auto& x : vec) {
+                sketch.add(x);
+            }
+        }
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Vereinigt zwei volle Sketches mit Puffergröße s über disjunkte Streams.
+// Treaps vereinigen ihre Puffer mit Treap::unite, der IndexedHeap fügt die Elemente einzeln ein.
+template<template<class, class> class Buffer>
+inline static auto knuth_merge(benchmark::State& state)
+{
+    auto s = static_cast<std::size_t>(state.range(0));
+
+    auto vec = random_vec<std::uint64_t>(4 * s);
+    cvm::KnuthSketch<std::uint64_t, Buffer> a(s);
+    cvm::KnuthSketch<std::uint64_t, Buffer> b(s);
+    for(std::size_t i = 0; i < vec.size(); i++) {
+        (i % 2 == 0 ? a : b).add(vec[i]);
+    }
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto merged = a;
+        state.ResumeTiming();
+
+        merged.merge(b);
+        benchmark::DoNotOptimize(merged.estimate());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * s));
+}
+
+// Synthetischer Stream mit Zeitstempeln: 1000 Elemente pro Zeiteinheit aus einer Population von Nutzern,
+// die langsam weiterwandert (pro Zeiteinheit kommen 100 neue Nutzer hinzu, aktiv sind die letzten 10000).
+// Windowed zählt im Fenster der letzten 300 Zeiteinheiten mit 10 Epochen, sonst zählt ein einzelner
+// KnuthSketch mit Priorities::hashed den ganzen Stream. Am Ende folgt jeweils eine Abfrage.
+template<bool Windowed>
+inline static auto knuth_windowed(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+    constexpr std::size_t per_tick = 1000;
+
+    auto vec = random_vec<std::uint64_t>(N);
+    for(std::size_t i = 0; i < N; i++) {
+        vec[i] = i / per_tick * 100 + vec[i] % 10000;
+    }
+
+    for(auto _ : state) {
+        if constexpr(Windowed) {
+            cvm::WindowedSketch<std::uint64_t> sketch(s, 300, 10);
+            for(std::size_t offset = 0; offset < N; offset += per_tick) {
+                const auto block = std::span<const std::uint64_t>(vec).subspan(offset, std::min(per_tick, N - offset));
+                sketch.add_batch(block, offset / per_tick);
+            }
+            benchmark::DoNotOptimize(sketch.estimate());
+        } else {
+            cvm::KnuthSketch<std::uint64_t, cvm::SlabTreap, cvm::Priorities::hashed> sketch(s);
+            sketch.add_batch(vec);
+            benchmark::DoNotOptimize(sketch.estimate());
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Knuth-Benchmark auf einem Stream mit vielen Wiederholungen: N Elemente aus nur N / 100 + 1 verschiedenen Werten.
+// Vergleicht zufällige Prioritäten pro Vorkommen mit Prioritäten aus einem Hash des Elements (Priorities::hashed).
+template<class T, cvm::Priorities Mode>
+inline static auto knuth_repeats(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_vec<T>(N);
+        const auto domain = static_cast<T>(N / 100 + 1);
+        for(auto& x : vec) {
+            x %= domain;
+        }
+        state.ResumeTiming();
+
+        auto result = cvm::knuth_cvm<cvm::SlabTreap, Mode>(std::begin(vec), std::end(vec), s);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Wie knuth_repeats mit zufälligen Prioritäten, aber mit exakter Phase (adaptive_knuth_cvm), solange die N / 100 + 1
+// verschiedenen Werte in den Puffer passen. Bei kleinerem s wechselt der Sketch zur Stichprobe.
+template<class T, bool Adaptive>
+inline static auto knuth_adaptive(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_vec<T>(N);
+        const auto domain = static_cast<T>(N / 100 + 1);
+        for(auto& x : vec) {
+            x %= domain;
+        }
+        state.ResumeTiming();
+
+        if constexpr(Adaptive) {
+            benchmark::DoNotOptimize(cvm::adaptive_knuth_cvm(std::begin(vec), std::end(vec), s));
+        } else {
+            benchmark::DoNotOptimize(cvm::knuth_cvm(std::begin(vec), std::end(vec), s));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Durchsatz des schreibenden Threads von ConcurrentSketch, während das dritte Argument an Lesern ununterbrochen
+// estimate() abfragt. Mit 0 Lesern zeigt der Vergleich mit knuth_block<..., true> die Kosten der Veröffentlichung.
+// Die Leser laufen auf eigenen Kernen, falls vorhanden, sonst teilen sie sich die Zeit mit dem Schreiber.
+inline static auto knuth_concurrent(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+    auto readers = static_cast<std::size_t>(state.range(2));
+
+    auto vec = random_vec<std::uint64_t>(N);
+    for(auto _ : state) {
+        cvm::ConcurrentSketch sketch{cvm::KnuthSketch<std::uint64_t>(s)};
+        std::atomic<bool> done = false;
+        std::vector<std::jthread> threads;
+        for(std::size_t r = 0; r < readers; r++) {
+            threads.emplace_back([&] {
+                while(!done.load(std::memory_order_relaxed)) {
+                    benchmark::DoNotOptimize(sketch.estimate());
+                }
+            });
+        }
+
+        sketch.add_batch(std::span<const std::uint64_t>(vec));
+        done = true;
+        threads.clear();
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// GroupedSketches mit G Gruppen und Puffergröße s über N Paare (Gruppe, Element) mit gleichverteilten Gruppen.
+// Batch verarbeitet Blöcke von 2^20 Paaren mit add_batch (Radix-Partitionierung), sonst jedes Paar einzeln mit add.
+// Der Zähler bytes_per_group gibt den Speicher der Gruppen samt Pool an.
+template<bool Batch>
+inline static auto grouped(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto G = static_cast<std::size_t>(state.range(1));
+    auto s = static_cast<std::size_t>(state.range(2));
+    constexpr std::size_t block = std::size_t{1} << 20;
+
+    auto elems = random_vec<std::uint64_t>(N);
+    std::vector<std::uint32_t> groups(N);
+    for(std::size_t i = 0; i < N; i++) {
+        groups[i] = static_cast<std::uint32_t>(elems[i] % G);
+    }
+
+    std::size_t memory = 0;
+    for(auto _ : state) {
+        cvm::GroupedSketches<std::uint64_t> sketches(G, s);
+        if constexpr(Batch) {
+            for(std::size_t offset = 0; offset < N; offset += block) {
+                const auto len = std::min(block, N - offset);
+                sketches.add_batch(std::span(groups).subspan(offset, len), std::span<const std::uint64_t>(elems).subspan(offset, len));
+            }
+        } else {
+            for(std::size_t i = 0; i < N; i++) {
+                sketches.add(groups[i], elems[i]);
+            }
+        }
+        benchmark::DoNotOptimize(sketches.estimate(0));
+        memory = sketches.memory_bytes();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    state.counters["bytes_per_group"] = static_cast<double>(memory) / static_cast<double>(G);
+}
+
+// Gesamtdurchsatz, wenn das zweite Argument an Produzenten-Threads gemeinsam N Elemente in einen Sketch einspeisen.
+// Rings: MultiProducerSketch (SPSC-Rings und ein Verbraucher-Thread), sonst ein Mutex um jedes einzelne Update.
+template<bool Rings>
+inline static auto ingest(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto producers = static_cast<std::size_t>(state.range(1));
+    const std::size_t s = 10000;
+
+    auto vec = random_vec<std::uint64_t>(N);
+    for(auto _ : state) {
+        const auto part = [&](std::size_t t) {
+            return std::span<const std::uint64_t>(vec).subspan(t * N / producers, (t + 1) * N / producers - t * N / producers);
+        };
+
+        if constexpr(Rings) {
+            cvm::MultiProducerSketch<std::uint64_t> sketch(cvm::KnuthSketch<std::uint64_t>(s), producers);
+            {
+                std::vector<std::jthread> threads;
+                for(std::size_t t = 0; t < producers; t++) {
+                    threads.emplace_back([&, t] {
+                        auto& producer = sketch.producer(t);
+                        for(const auto elem : part(t)) {
+                            producer.push(elem);
+                        }
+                    });
+                }
+            }
+            benchmark::DoNotOptimize(sketch.finish().estimate());
+        } else {
+            cvm::KnuthSketch<std::uint64_t> sketch(s);
+            std::mutex mutex;
+            {
+                std::vector<std::jthread> threads;
+                for(std::size_t t = 0; t < producers; t++) {
+                    threads.emplace_back([&, t] {
+                        for(const auto elem : part(t)) {
+                            std::lock_guard lock(mutex);
+                            sketch.add(elem);
+                        }
+                    });
+                }
+            }
+            benchmark::DoNotOptimize(sketch.estimate());
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Wie knuth<T>, aber die Elemente werden vorher blockweise zu 64-Bit-Fingerabdrücken gehasht (HashedSketch).
+template<class T>
+inline static auto knuth_hashed(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_input<T>(N);
+        state.ResumeTiming();
+
+        cvm::HashedSketch<T> sketch{cvm::KnuthSketch<std::uint64_t>(s)};
+        sketch.add_batch(vec);
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Wie naive<T>, aber die Elemente werden vorher blockweise zu 64-Bit-Fingerabdrücken gehasht (HashedSketch).
+template<class T>
+inline static auto naive_hashed(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    double eps = static_cast<double>(state.range(1)) / 10.;
+    double delta = static_cast<double>(state.range(2)) * 0.0001;
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_input<T>(N);
+        state.ResumeTiming();
+
+        cvm::HashedSketch<T, cvm::NaiveSketch<std::uint64_t>> sketch(cvm::NaiveSketch<std::uint64_t>(eps, delta, N));
+        sketch.add_batch(vec);
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Template-Funktion für die parallelen Varianten. Das dritte Argument ist die Anzahl der Threads.
+// Die Durchsatzangabe (items_per_second) sollte bis zur Anzahl der Kerne nahezu linear mit den Threads wachsen.
+template<class T, bool Knuth>
+inline static auto parallel(benchmark::State& state)
+{
+    auto N = static_cast<std::size_t>(state.range(0));
+    auto s = static_cast<std::size_t>(state.range(1));
+    auto threads = static_cast<std::size_t>(state.range(2));
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto vec = random_vec<T>(N);
+        state.ResumeTiming();
+
+        if constexpr(Knuth) {
+            auto result = cvm::parallel_knuth_cvm(std::begin(vec), std::end(vec), s, threads);
+            benchmark::DoNotOptimize(result);
+        } else {
+            auto result = cvm::parallel_naive_cvm(std::begin(vec), std::end(vec), 0.5, 0.01, threads);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+// Argumente für knuth_block: nur große Puffer, bei denen das Prefetching greift.
+static void CustomArgumentsKnuthBlock(benchmark::internal::Benchmark* b)
+{
+    for(std::int64_t N = 1000000; N <= 10000000; N *= 10) {
+        for(std::int64_t s = 100000; s <= N; s *= 10) {
+            b->Args({N, s});
+        }
+    }
+}
+
 // Funktion, die benutzerdefinierte Argumente für den Naiven Benchmark festlegt.
 static void CustomArgumentsNaive(benchmark::internal::Benchmark* b)
 {
@@ -152,11 +580,107 @@ static void CustomArgumentsKnuth(benchmark::internal::Benchmark* b)
     }
 }
 
+// Funktion, die benutzerdefinierte Argumente für die parallelen Benchmarks festlegt.
+// Die Anzahl der Threads wird in Zweierpotenzen bis zur Anzahl der Kerne erhöht.
+static void CustomArgumentsParallel(benchmark::internal::Benchmark* b)
+{
+    const auto cores = static_cast<std::int64_t>(cvm::default_threads());
+    for(std::int64_t N = 1000000; N <= 10000000; N *= 10) {
+        for(std::int64_t s = 1000; s <= 100000; s *= 10) {
+            for(std::int64_t threads = 1; threads <= cores; threads *= 2) {
+                b->Args({N, s, threads});
+            }
+            if((cores & (cores - 1)) != 0) {
+                b->Args({N, s, cores});
+            }
+        }
+    }
+}
+
+// Argumente für die Benchmarks mit Zeichenketten. Kleinere Streams, da jede Zeichenkette auf dem Heap liegt.
+static void CustomArgumentsKnuthStrings(benchmark::internal::Benchmark* b)
+{
+    for(std::int64_t N = 1000; N <= 1000000; N *= 10) {
+        for(std::int64_t s = 100; s <= N && s <= 100000; s *= 10) {
+            b->Args({N, s});
+        }
+    }
+}
+
+// Argumente für den naiven Benchmark mit Zeichenketten (eps = 0.5, delta = 0.01).
+static void CustomArgumentsNaiveStrings(benchmark::internal::Benchmark* b)
+{
+    for(std::int64_t N = 1000; N <= 1000000; N *= 10) {
+        b->Args({N, 5, 100});
+    }
+}
+
 // BENCHMARK(knuth<std::uint8_t>)->Apply(CustomArgumentsKnuth);
 // BENCHMARK(knuth<std::uint16_t>)->Apply(CustomArgumentsKnuth);
 // BENCHMARK(knuth<std::uint32_t>)->Apply(CustomArgumentsKnuth);
 // BENCHMARK(knuth<std::uint64_t>)->Apply(CustomArgumentsKnuth);
 
+// Vergleich der Puffer: Treap mit Zeigern (SlabTreap), Treap mit 32-Bit-Indizes in einem Array (IndexTreap)
+// und Max-Heap im Array mit Hash-Index (IndexedHeap).
+BENCHMARK(knuth<std::uint32_t, cvm::SlabTreap>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth<std::uint32_t, cvm::IndexTreap>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth<std::uint32_t, cvm::IndexedHeap>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth<std::uint64_t, cvm::SlabTreap>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth<std::uint64_t, cvm::IndexTreap>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth<std::uint64_t, cvm::IndexedHeap>)->Apply(CustomArgumentsKnuth);
+
+// Vergleich pro Element: einzelne Treap-Operationen gegen den fusionierten Schritt cvm_update.
+BENCHMARK(knuth_step<std::uint32_t, false>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth_step<std::uint32_t, true>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth_step<std::uint64_t, false>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth_step<std::uint64_t, true>)->Apply(CustomArgumentsKnuth);
+
+// Einzelne Updates gegen Blöcke mit Prefetching bei großen Puffern.
+BENCHMARK(knuth_block<std::uint64_t, cvm::SlabTreap, false>)->Apply(CustomArgumentsKnuthBlock);
+BENCHMARK(knuth_block<std::uint64_t, cvm::SlabTreap, true>)->Apply(CustomArgumentsKnuthBlock);
+BENCHMARK(knuth_block<std::uint64_t, cvm::IndexedHeap, false>)->Apply(CustomArgumentsKnuthBlock);
+BENCHMARK(knuth_block<std::uint64_t, cvm::IndexedHeap, true>)->Apply(CustomArgumentsKnuthBlock);
+
+// Vereinigung zweier Sketches.
+BENCHMARK(knuth_merge<cvm::SlabTreap>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(knuth_merge<cvm::IndexedHeap>)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// Exakte Phase bis zum vollen Puffer, verglichen mit knuth_cvm auf demselben Stream mit vielen Wiederholungen.
+BENCHMARK(knuth_adaptive<std::uint64_t, false>)->ArgsProduct({{1000000, 10000000}, {1000, 100000, 1000000}});
+BENCHMARK(knuth_adaptive<std::uint64_t, true>)->ArgsProduct({{1000000, 10000000}, {1000, 100000, 1000000}});
+
+// Ein Schreiber mit 0 bis 2 Lesern, die ununterbrochen die Schätzung abfragen.
+BENCHMARK(knuth_concurrent)->ArgsProduct({{10000000}, {1000, 100000}, {0, 1, 2}})->UseRealTime();
+
+// Viele kleine Sketches: 10^6 Gruppen mit im Mittel 2 bzw. 20 Elementen pro Gruppe.
+BENCHMARK(grouped<false>)->ArgsProduct({{2000000, 20000000}, {1000000}, {16, 256}});
+BENCHMARK(grouped<true>)->ArgsProduct({{2000000, 20000000}, {1000000}, {16, 256}});
+
+// Mehrere Produzenten, ein Sketch: SPSC-Rings mit Verbraucher-Thread gegen einen Mutex pro Update.
+BENCHMARK(ingest<false>)->ArgsProduct({{10000000}, {1, 2, 4, 8}})->UseRealTime();
+BENCHMARK(ingest<true>)->ArgsProduct({{10000000}, {1, 2, 4, 8}})->UseRealTime();
+
+// Zeitfenster über einen Stream mit Zeitstempeln, verglichen mit einem Sketch über den ganzen Stream.
+BENCHMARK(knuth_windowed<false>)->ArgsProduct({{1000000, 10000000}, {1000, 10000, 100000}});
+BENCHMARK(knuth_windowed<true>)->ArgsProduct({{1000000, 10000000}, {1000, 10000, 100000}});
+
+// Streams mit vielen Wiederholungen: zufällige Prioritäten gegen Prioritäten aus dem Hash des Elements.
+BENCHMARK(knuth_repeats<std::uint64_t, cvm::Priorities::random>)->Apply(CustomArgumentsKnuth);
+BENCHMARK(knuth_repeats<std::uint64_t, cvm::Priorities::hashed>)->Apply(CustomArgumentsKnuth);
+
+// Zeichenketten direkt im Treap bzw. Hashset gegen 64-Bit-Fingerabdrücke aus der Hash-Stufe.
+BENCHMARK(knuth<std::string>)->Apply(CustomArgumentsKnuthStrings);
+BENCHMARK(knuth_hashed<std::string>)->Apply(CustomArgumentsKnuthStrings);
+BENCHMARK(naive<std::string>)->Apply(CustomArgumentsNaiveStrings);
+BENCHMARK(naive_hashed<std::string>)->Apply(CustomArgumentsNaiveStrings);
+
+// Für Ganzzahlen kostet die Hash-Stufe nur das Mischen, das mit AVX2 vier Schlüssel pro Befehl verarbeitet.
+BENCHMARK(knuth_hashed<std::uint64_t>)->Apply(CustomArgumentsKnuth);
+
+// Skalierung der parallelen Varianten mit der Anzahl der Threads (Argumente: N, s, Threads).
+BENCHMARK(parallel<std::uint64_t, true>)->Apply(CustomArgumentsParallel)->UseRealTime();
+BENCHMARK(parallel<std::uint64_t, false>)->Apply(CustomArgumentsParallel)->UseRealTime();
+
 BENCHMARK(naive<std::uint8_t>)->Apply(CustomArgumentsNaive);
 BENCHMARK(naive<std::uint16_t>)->Apply(CustomArgumentsNaive);
 BENCHMARK(naive<std::uint32_t>)->Apply(CustomArgumentsNaive);
@@ -1,3 +1,4 @@
 option(BUILD_TESTS "build tests" OFF)
 option(BUILD_BENCHMARKS "build benchmarks" OFF)
 option(BUILD_EXAMPLES "build examples" OFF)
+option(BUILD_TOOLS "build command-line tools" OFF)
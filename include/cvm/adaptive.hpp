@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cvm/bitmap.hpp>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/flat_set.hpp>
+#include <cvm/random.hpp>
+#include <cvm/treap.hpp>
+
+namespace cvm {
+
+// Knuth-Sketch, der zunächst exakt zählt und erst bei Bedarf zur Stichprobe übergeht.
+//
+// Solange höchstens s verschiedene Elemente vorkamen, liegen sie in einem FlatSet: Pro Element kostet das einen Hash
+// und eine Sondierung, ohne Zufallszahl und ohne Prioritäten. Die Zählung ist in dieser Phase exakt, und der Knuth-Sketch
+// hätte sie ebenfalls geliefert (p = 1). Kommt das (s + 1)-te verschiedene Element, werden die s Elemente in einem
+// Schritt in den KnuthSketch übernommen (siehe KnuthSketch::assign_distinct) und alle weiteren Elemente dort verarbeitet.
+// Das Ergebnis hat dieselbe Verteilung wie bei einem KnuthSketch von Anfang an.
+template<class T, template<class, class> class Buffer = SlabTreap, Priorities Mode = Priorities::random,
+         std::uniform_random_bit_generator Rng = WyRand>
+class AdaptiveSketch
+{
+public:
+    // Typ des Sketches nach dem Übergang zur Stichprobe.
+    using SketchType = KnuthSketch<T, Buffer, Mode, Rng>;
+
+    // Erzeugt einen leeren Sketch mit Puffergröße s.
+    explicit AdaptiveSketch(std::size_t s, Rng rng = Rng{random_seed()}) noexcept
+        : sketch_(s, std::move(rng))
+    {
+    }
+
+    // Legt Platz für 'expected_distinct' verschiedene Elemente (höchstens s) im Voraus an.
+    auto reserve(std::size_t expected_distinct) noexcept -> void
+    {
+        exact_.reserve(std::min(sketch_.capacity(), expected_distinct));
+    }
+
+    // Verarbeitet ein Element des Streams.
+    auto add(const T& elem) noexcept -> void
+    {
+        if(sampled_) {
+            sketch_.add(elem);
+        } else if(exact_.size() < sketch_.capacity()) {
+            exact_.insert(elem);
+        } else if(!exact_.contains(elem)) {
+            switch_to_sampling();
+            sketch_.add(elem);
+        }
+    }
+
+    // Verarbeitet einen Block von Elementen in Stream-Reihenfolge. Nach dem Übergang geht der Rest des Blocks
+    // an KnuthSketch::add_batch.
+    auto add_batch(std::span<const T> elems) noexcept -> void
+    {
+        std::size_t i = 0;
+        for(; i < elems.size() && !sampled_; i++) {
+            add(elems[i]);
+        }
+        // clang-format off
+        if(i < elems.size()) sketch_.add_batch(elems.subspan(i));
+        // clang-format on
+    }
+
+    // true, solange noch exakt gezählt wird.
+    [[nodiscard]] auto exact() const noexcept -> bool
+    {
+        return !sampled_;
+    }
+
+    // Aktuelle Schätzung der Anzahl verschiedener Elemente (in der exakten Phase die genaue Anzahl).
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return sampled_ ? sketch_.estimate() : static_cast<double>(exact_.size());
+    }
+
+    // Maximale Anzahl gepufferter Elemente.
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return sketch_.capacity();
+    }
+
+private:
+    // Übernimmt die exakt gezählten Elemente in den KnuthSketch und gibt das Set frei.
+    auto switch_to_sampling() noexcept -> void
+    {
+        std::vector<T> distinct;
+        distinct.reserve(exact_.size());
+        exact_.for_each([&](const T& elem) { distinct.push_back(elem); });
+
+        sketch_.assign_distinct(distinct);
+        exact_ = FlatSet<T>{};
+        sampled_ = true;
+    }
+
+    FlatSet<T> exact_;     // Alle bisherigen Elemente, solange es höchstens s verschiedene sind.
+    SketchType sketch_;    // Stichprobe nach dem Übergang, davor leer.
+    bool sampled_ = false; // true nach dem Übergang zur Stichprobe.
+};
+
+// Knuth Version des CVM-Algorithmus mit exakter Phase (siehe AdaptiveSketch).
+// Bei höchstens s verschiedenen Elementen ist das Ergebnis exakt und kostet nur Sondierungen in einem Hashset.
+// Für Schlüssel mit höchstens 16 Bit (NarrowKey) wird wie bei knuth_cvm über eine Bitmap gezählt.
+template<template<class, class> class Buffer = SlabTreap, Priorities Mode = Priorities::random, class Iter,
+         std::uniform_random_bit_generator Rng = WyRand>
+[[nodiscard]] static auto adaptive_knuth_cvm(Iter begin, Iter end, std::size_t s, Rng rng = Rng{random_seed()}) noexcept
+    -> std::optional<double>
+{
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    if constexpr(NarrowKey<ItemType>) {
+        return bitmap_count(begin, end);
+    } else {
+        AdaptiveSketch<ItemType, Buffer, Mode, Rng> sketch(s, std::move(rng));
+        if constexpr(std::contiguous_iterator<Iter>) {
+            sketch.add_batch(std::span<const ItemType>(std::to_address(begin), static_cast<std::size_t>(end - begin)));
+        } else {
+            for(auto it = begin; it != end; ++it) {
+                sketch.add(*it);
+            }
+        }
+
+        return sketch.estimate();
+    }
+}
+
+} // namespace cvm
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cvm {
+
+// Slab-Arena mit Freiliste für Objekte vom Typ T.
+// Der Speicher wird in zusammenhängenden Blöcken (Slabs) angefordert und nie einzeln an das System zurückgegeben.
+// Freigegebene Objekte landen in einer Freiliste und werden beim nächsten create() wiederverwendet,
+// sodass nach dem Aufwärmen keine Heap-Allokationen mehr stattfinden.
+template<class T>
+class SlabArena
+{
+public:
+    // Objekte werden über gewöhnliche Zeiger referenziert.
+    using link = T*;
+    constexpr static link null = nullptr;
+
+    // Erzeugt eine Arena, die bereits Platz für 'capacity' Objekte in einem einzigen Slab hat.
+    explicit SlabArena(std::size_t capacity = 0) noexcept
+    {
+        reserve(capacity);
+    }
+
+    SlabArena(const SlabArena&) = delete;
+    auto operator=(const SlabArena&) -> SlabArena& = delete;
+
+    SlabArena(SlabArena&& other) noexcept
+        : slabs_(std::move(other.slabs_)),
+          free_(std::exchange(other.free_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0))
+    {
+    }
+
+    auto operator=(SlabArena&& other) noexcept -> SlabArena&
+    {
+        slabs_ = std::move(other.slabs_);
+        free_ = std::exchange(other.free_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        return *this;
+    }
+
+    // Konstruiert ein Objekt in einem freien Slot.
+    // Ist die Freiliste leer, wird ein neuer Slab angelegt, der so groß ist wie alle bisherigen zusammen.
+    template<class... Args>
+    [[nodiscard]] auto create(Args&&... args) noexcept -> T*
+    {
+        if(!free_) [[unlikely]] {
+            add_slab(std::max<std::size_t>(capacity_, 16));
+        }
+
+        auto* const slot = std::exchange(free_, free_->next);
+        return ::new(static_cast<void*>(slot->storage)) T{std::forward<Args>(args)...};
+    }
+
+    // Zerstört ein Objekt und hängt seinen Slot vorne an die Freiliste.
+    auto destroy(T* obj) noexcept -> void
+    {
+        obj->~T();
+        auto* const slot = reinterpret_cast<Slot*>(obj);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    // Stellt sicher, dass insgesamt mindestens 'capacity' Slots vorhanden sind.
+    auto reserve(std::size_t capacity) noexcept -> void
+    {
+        if(capacity > capacity_) {
+            add_slab(capacity - capacity_);
+        }
+    }
+
+    [[nodiscard]] constexpr auto operator[](link obj) const noexcept -> T&
+    {
+        return *obj;
+    }
+
+    // Anzahl der Slots über alle Slabs.
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return capacity_;
+    }
+
+private:
+    // Ein Slot enthält entweder ein lebendes Objekt oder den Zeiger auf den nächsten freien Slot.
+    union Slot
+    {
+        Slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    // Legt einen neuen Slab mit 'count' Slots an und fädelt alle Slots in die Freiliste ein.
+    // Die Slots werden so verkettet, dass sie in Speicherreihenfolge vergeben werden.
+    auto add_slab(std::size_t count) noexcept -> void
+    {
+        auto slab = std::make_unique_for_overwrite<Slot[]>(count);
+        for(std::size_t i = count; i > 0; i--) {
+            slab[i - 1].next = free_;
+            free_ = &slab[i - 1];
+        }
+
+        slabs_.emplace_back(std::move(slab));
+        capacity_ += count;
+    }
+
+private:
+    std::vector<std::unique_ptr<Slot[]>> slabs_; // Alle angeforderten Speicherblöcke.
+    Slot* free_ = nullptr;                       // Kopf der Freiliste.
+    std::size_t capacity_ = 0;                   // Gesamtzahl der Slots.
+};
+
+// Allokator, der jedes Objekt einzeln mit new/delete anlegt.
+// Entspricht dem ursprünglichen Verhalten des Treaps und dient als Vergleich in den Benchmarks.
+template<class T>
+class HeapAllocator
+{
+public:
+    using link = T*;
+    constexpr static link null = nullptr;
+
+    explicit HeapAllocator(std::size_t /*capacity*/ = 0) noexcept {}
+
+    template<class... Args>
+    [[nodiscard]] auto create(Args&&... args) noexcept -> T*
+    {
+        return new T{std::forward<Args>(args)...};
+    }
+
+    auto destroy(T* obj) noexcept -> void
+    {
+        delete obj;
+    }
+
+    auto reserve(std::size_t /*capacity*/) noexcept -> void {}
+
+    [[nodiscard]] constexpr auto operator[](link obj) const noexcept -> T&
+    {
+        return *obj;
+    }
+};
+
+// Arena, die alle Objekte in einem einzigen zusammenhängenden Array hält und sie über 32-Bit-Indizes referenziert.
+// Verglichen mit Zeigern halbiert das die Größe der Verweise, sodass mehr Knoten in L1/L2 passen.
+// Beim Wachsen wird das Array umkopiert, daher muss T trivial kopierbar sein und Referenzen auf Objekte
+// bleiben nur bis zum nächsten create() gültig.
+template<class T>
+class IndexArena
+{
+public:
+    using link = std::uint32_t;
+    constexpr static link null = std::numeric_limits<link>::max();
+
+    // Erzeugt eine Arena, die bereits Platz für 'capacity' Objekte hat.
+    explicit IndexArena(std::size_t capacity = 0) noexcept
+    {
+        reserve(capacity);
+    }
+
+    IndexArena(const IndexArena&) = delete;
+    auto operator=(const IndexArena&) -> IndexArena& = delete;
+
+    IndexArena(IndexArena&& other) noexcept
+        : slots_(std::move(other.slots_)),
+          free_(std::exchange(other.free_, null))
+    {
+    }
+
+    auto operator=(IndexArena&& other) noexcept -> IndexArena&
+    {
+        slots_ = std::move(other.slots_);
+        free_ = std::exchange(other.free_, null);
+        return *this;
+    }
+
+    // Konstruiert ein Objekt in einem freien Slot oder hängt einen neuen Slot an das Array an.
+    template<class... Args>
+    [[nodiscard]] auto create(Args&&... args) noexcept -> link
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "IndexArena relocates objects and needs trivially copyable types");
+
+        link idx;
+        if(free_ != null) {
+            idx = free_;
+            free_ = slots_[idx].next;
+        } else {
+            idx = static_cast<link>(slots_.size());
+            slots_.emplace_back();
+        }
+
+        ::new(static_cast<void*>(slots_[idx].storage)) T{std::forward<Args>(args)...};
+        return idx;
+    }
+
+    // Gibt den Slot eines Objekts an die Freiliste zurück.
+    auto destroy(link idx) noexcept -> void
+    {
+        slots_[idx].next = free_;
+        free_ = idx;
+    }
+
+    auto reserve(std::size_t capacity) noexcept -> void
+    {
+        slots_.reserve(capacity);
+    }
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return slots_.capacity();
+    }
+
+    [[nodiscard]] auto operator[](link idx) noexcept -> T&
+    {
+        return *std::launder(reinterpret_cast<T*>(slots_[idx].storage));
+    }
+
+    [[nodiscard]] auto operator[](link idx) const noexcept -> const T&
+    {
+        return *std::launder(reinterpret_cast<const T*>(slots_[idx].storage));
+    }
+
+private:
+    // Ein Slot enthält entweder ein Objekt oder den Index des nächsten freien Slots.
+    union Slot
+    {
+        link next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    std::vector<Slot> slots_; // Alle Slots in einem zusammenhängenden Array.
+    link free_ = null;        // Index des ersten freien Slots.
+};
+
+} // namespace cvm
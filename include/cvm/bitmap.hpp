@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace cvm {
+
+// Ganzzahlige Schlüssel mit höchstens 16 Bit. Ihr Wertebereich passt in eine Bitmap von höchstens 8 KiB
+// (32 Bytes bei 8 Bit), damit ist eine exakte Zählung billiger als jede Stichprobe.
+template<class T>
+concept NarrowKey = std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 2;
+
+// Exakter Zähler verschiedener Elemente über eine Bitmap mit einem Bit pro möglichem Wert.
+// add setzt nur ein Bit, count zählt die gesetzten Bits mit std::popcount. Die Schleife über die Wörter
+// vektorisiert der Compiler, wo das Ziel einen Popcount für Vektoren hat (z.B. AVX-512 VPOPCNTDQ).
+template<NarrowKey T>
+class BitmapCounter
+{
+public:
+    // Anzahl der möglichen Werte von T.
+    constexpr static std::size_t domain = std::size_t{1} << (8 * sizeof(T));
+
+    // Verarbeitet ein Element des Streams.
+    auto add(T elem) noexcept -> void
+    {
+        const auto idx = static_cast<std::make_unsigned_t<T>>(elem);
+        words_[idx / 64] |= std::uint64_t{1} << (idx % 64);
+    }
+
+    // Verarbeitet einen Block von Elementen.
+    auto add_batch(std::span<const T> elems) noexcept -> void
+    {
+        for(const auto elem : elems) {
+            add(elem);
+        }
+    }
+
+    // Vereinigt den Zähler mit 'other'.
+    auto merge(const BitmapCounter& other) noexcept -> void
+    {
+        for(std::size_t i = 0; i < words; i++) {
+            words_[i] |= other.words_[i];
+        }
+    }
+
+    // Exakte Anzahl verschiedener Elemente.
+    [[nodiscard]] auto count() const noexcept -> std::size_t
+    {
+        std::size_t total = 0;
+        for(const auto word : words_) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    // Anzahl verschiedener Elemente als double, wie bei den Sketches.
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return static_cast<double>(count());
+    }
+
+    // true, wenn jeder mögliche Wert schon vorgekommen ist. Dann ändern weitere Elemente nichts mehr.
+    [[nodiscard]] auto full() const noexcept -> bool
+    {
+        return std::all_of(words_.begin(), words_.end(),
+                           [](std::uint64_t word) { return word == std::numeric_limits<std::uint64_t>::max(); });
+    }
+
+private:
+    constexpr static std::size_t words = domain / 64;
+
+    std::array<std::uint64_t, words> words_{}; // Bit x ist gesetzt, wenn x vorgekommen ist.
+};
+
+// Exakte Anzahl verschiedener Elemente eines Streams mit schmalen Schlüsseln.
+// Alle full_check_interval Elemente wird geprüft, ob schon jeder Wert vorkam, dann muss der Rest nicht gelesen werden.
+template<std::input_iterator Iter>
+    requires NarrowKey<typename std::iterator_traits<Iter>::value_type>
+[[nodiscard]] static auto bitmap_count(Iter begin, Iter end) noexcept -> double
+{
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+    constexpr std::size_t full_check_interval = std::size_t{1} << 16;
+
+    BitmapCounter<ItemType> counter;
+    if constexpr(std::contiguous_iterator<Iter>) {
+        const auto elems = std::span<const ItemType>(std::to_address(begin), static_cast<std::size_t>(end - begin));
+        for(std::size_t offset = 0; offset < elems.size() && !counter.full(); offset += full_check_interval) {
+            counter.add_batch(elems.subspan(offset, std::min(full_check_interval, elems.size() - offset)));
+        }
+    } else {
+        std::size_t since_check = 0;
+        for(auto it = begin; it != end; ++it) {
+            counter.add(*it);
+            if(++since_check == full_check_interval) {
+                // clang-format off
+                if(counter.full()) break;
+                // clang-format on
+                since_check = 0;
+            }
+        }
+    }
+    return counter.estimate();
+}
+
+} // namespace cvm
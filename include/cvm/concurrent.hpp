@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace cvm {
+
+// Momentaufnahme eines Sketches, die ConcurrentSketch veröffentlicht.
+struct SketchSnapshot
+{
+    std::size_t size = 0; // Anzahl der gepufferten Elemente.
+    double p = 1;         // Schwelle bzw. Wahrscheinlichkeit, mit der ein Element im Puffer liegt.
+
+    // Schätzung der Anzahl verschiedener Elemente zum Zeitpunkt der Aufnahme.
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return static_cast<double>(size) / p;
+    }
+};
+
+// Hülle um einen Sketch, in die genau ein Thread schreibt, während beliebig viele Threads jederzeit die Schätzung lesen.
+//
+// Nur der schreibende Thread darf add, add_batch und sketch() aufrufen. Nach jeder Änderung von size() oder
+// probability() veröffentlicht er beide Werte über ein Seqlock: Die Sequenznummer ist während des Schreibens ungerade.
+// Ein Leser liest die Nummer, dann die Werte, dann erneut die Nummer, und wiederholt das, falls sie ungerade war
+// oder sich geändert hat. Leser nehmen also keine Sperre und halten den Schreiber nie auf, der Schreiber zahlt pro
+// Veröffentlichung nur einige Speicherzugriffe auf einer eigenen Cache-Zeile.
+// Sketch muss size() und probability() anbieten, z.B. KnuthSketch. Rückgabewerte von add werden nicht ausgewertet.
+template<class Sketch>
+class ConcurrentSketch
+{
+public:
+    // Übernimmt einen leeren (oder bereits gefüllten) Sketch.
+    explicit ConcurrentSketch(Sketch sketch) noexcept
+        : sketch_(std::move(sketch))
+    {
+        publish();
+    }
+
+    // Verarbeitet ein Element des Streams (nur der schreibende Thread).
+    template<class T>
+    auto add(const T& elem) noexcept -> void
+    {
+        sketch_.add(elem);
+        publish_if_changed();
+    }
+
+    // Verarbeitet einen Block von Elementen (nur der schreibende Thread).
+    // Veröffentlicht wird nach jedem Stück von publish_chunk Elementen, damit Leser auch während eines großen Blocks
+    // aktuelle Werte sehen.
+    template<class T>
+    auto add_batch(std::span<const T> elems) noexcept -> void
+    {
+        for(std::size_t offset = 0; offset < elems.size(); offset += publish_chunk) {
+            sketch_.add_batch(elems.subspan(offset, std::min(publish_chunk, elems.size() - offset)));
+            publish_if_changed();
+        }
+    }
+
+    // Der innere Sketch (nur der schreibende Thread).
+    [[nodiscard]] auto sketch() const noexcept -> const Sketch&
+    {
+        return sketch_;
+    }
+
+    // Zuletzt veröffentlichte Werte (beliebiger Thread, ohne Sperre).
+    [[nodiscard]] auto snapshot() const noexcept -> SketchSnapshot
+    {
+        while(true) {
+            const auto before = published_.seq.load(std::memory_order_acquire);
+            SketchSnapshot result{published_.size.load(std::memory_order_relaxed),
+                                  published_.p.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto after = published_.seq.load(std::memory_order_relaxed);
+            if(before == after && before % 2 == 0) {
+                return result;
+            }
+        }
+    }
+
+    // Schätzung aus der zuletzt veröffentlichten Momentaufnahme (beliebiger Thread, ohne Sperre).
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return snapshot().estimate();
+    }
+
+private:
+    // Anzahl der Elemente in add_batch, nach denen spätestens veröffentlicht wird.
+    constexpr static std::size_t publish_chunk = 4096;
+
+    // Veröffentlicht nur, wenn sich size() oder probability() seit der letzten Veröffentlichung geändert haben.
+    // p wird bitweise verglichen, jede Änderung des Werts zählt.
+    auto publish_if_changed() noexcept -> void
+    {
+        const double p = sketch_.probability();
+        const auto p_changed = std::bit_cast<std::uint64_t>(p) != std::bit_cast<std::uint64_t>(last_.p);
+        if(sketch_.size() != last_.size || p_changed) {
+            publish();
+        }
+    }
+
+    auto publish() noexcept -> void
+    {
+        last_ = SketchSnapshot{sketch_.size(), sketch_.probability()};
+
+        const auto seq = published_.seq.load(std::memory_order_relaxed);
+        published_.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        published_.size.store(last_.size, std::memory_order_relaxed);
+        published_.p.store(last_.p, std::memory_order_relaxed);
+        published_.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Veröffentlichte Werte auf einer eigenen Cache-Zeile, damit Leser nicht die Daten des Sketches verdrängen.
+    struct alignas(64) Published
+    {
+        std::atomic<std::uint64_t> seq = 0;  // Ungerade, während der Schreiber die Werte ändert.
+        std::atomic<std::size_t> size = 0;
+        std::atomic<double> p = 1;
+    };
+
+    Sketch sketch_;         // Nur vom schreibenden Thread benutzt.
+    SketchSnapshot last_;   // Zuletzt veröffentlichte Werte, Kopie des Schreibers.
+    Published published_;   // Für Leser.
+};
+
+} // namespace cvm
@@ -2,74 +2,403 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <random>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <cvm/bitmap.hpp>
+#include <cvm/hash.hpp>
+#include <cvm/indexed_heap.hpp>
+#include <cvm/random.hpp>
+#include <cvm/serialize.hpp>
 #include <cvm/treap.hpp>
 
 namespace cvm {
 
 
-// Knuth Version des CVM-Algorithmus mit Treap
-template<class Iter>
-[[nodiscard]] static auto knuth_cvm(Iter begin, Iter end, std::size_t s) noexcept
-    -> std::optional<double>
+// Herkunft der Prioritäten in der Knuth Version des CVM-Algorithmus.
+enum class Priorities {
+    // Jedes Vorkommen eines Elements bekommt eine neue Zufallszahl.
+    random,
+    // Die Priorität ist ein Hash des Elements mit einem zufälligen Seed und bei jedem Vorkommen gleich.
+    // Wiederholungen kosten dann meist nur einen Vergleich mit p oder der Wurzel, der Generator wird nur für den Seed gebraucht.
+    // Das Ergebnis hängt nur noch von der Menge der verschiedenen Elemente ab, nicht von Reihenfolge oder Häufigkeit.
+    hashed,
+};
+
+// Zustandsbehafteter Sketch für die Knuth Version des CVM-Algorithmus.
+// Die Elemente können einzeln oder blockweise hinzugefügt werden, die Schätzung ist jederzeit abrufbar,
+// ohne den Stream erneut zu lesen. Die Länge des Streams muss dafür nicht bekannt sein.
+// Der Puffer enthält die höchstens s Elemente mit den kleinsten Prioritäten unterhalb von p.
+// Buffer wählt den Container des Puffers: SlabTreap (Treap mit Zeigern), IndexTreap (Treap mit 32-Bit-Indizes)
+// oder IndexedHeap (Max-Heap im Array mit Hash-Index).
+// Mode wählt, woher die Prioritäten kommen (siehe Priorities).
+template<class T, template<class, class> class Buffer = SlabTreap, Priorities Mode = Priorities::random,
+         std::uniform_random_bit_generator Rng = WyRand>
+class KnuthSketch
 {
-    // Typ der Elemente des Streams
-    using ItemType = typename std::iterator_traits<Iter>::value_type;
+public:
+    // Typ des Puffers, Key=T Prio=double
+    using BufferType = Buffer<T, double>;
 
-    // Typ des Treaps, Key=ItemType Prio=double
-    using TreapType = Treap<ItemType, double>;
+    // Erzeugt einen leeren Sketch mit Puffergröße s.
+    // Die Prioritäten (bzw. der Seed des Hashs) werden aus 'rng' gezogen.
+    // Mit einem festen Seed, z.B. WyRand{42}, ist das Ergebnis reproduzierbar.
+    explicit KnuthSketch(std::size_t s, Rng rng = Rng{random_seed()}) noexcept
+        : s_(s),
+          rng_(std::move(rng))
+    {
+        if constexpr(Mode == Priorities::hashed) {
+            seed_ = rng_();
+        }
+    }
 
-    double p = 1;
+    // Legt die Knoten für 'expected_distinct' verschiedene Elemente (höchstens s) im Voraus an.
+    // Beim Verdrängen wird kurzzeitig ein Knoten mehr benötigt, bevor die Wurzel entfernt wird.
+    auto reserve(std::size_t expected_distinct) noexcept -> void
+    {
+        buffer_.reserve(std::min(s_, expected_distinct) + 1);
+    }
 
-    // Initialisiere leeren Treap
-    TreapType B;
+    // Verarbeitet ein Element des Streams.
+    auto add(const T& elem) noexcept -> void
+    {
+        if constexpr(Mode == Priorities::hashed) {
+            // Gleiche Elemente haben die gleiche Priorität, daher muss nur ein fehlendes Element eingefügt werden.
+            p_ = buffer_.cvm_update_fixed(elem, priority(elem), p_, s_);
+        } else {
+            // Generiere eine neue priority für den Heap
+            const auto u = uniform01(rng_);
 
+            // Ein Schritt des Algorithmus in einem Abstieg durch den Treap bzw. einer Suche im Heap:
+            // Das Element wird gelöscht und, falls u < p, wieder eingefügt. Ist der Treap voll, wird entweder
+            // das Top Element mit der größten Priorität verdrängt oder p auf u gesenkt.
+            p_ = buffer_.cvm_update(elem, u, p_, s_);
+        }
+    }
 
-    // Iteriere über die Elemente des Streams
-    for(auto it = begin; it != end; ++it) {
+    // Priorität eines Elements im Modus Priorities::hashed: gleichverteilt in [0, 1) und durch Seed und Element festgelegt.
+    [[nodiscard]] auto priority(const T& elem) const noexcept -> double
+        requires(Mode == Priorities::hashed)
+    {
+        return to_unit_double(mix64(Hash<T>{}(elem) ^ seed_));
+    }
 
-        // Lösche des neue Element aus dem Treap
-        B.delete_elem(*it);
+    // Seed des Hashs im Modus Priorities::hashed. Nur Sketches mit gleichem Seed lassen sich exakt vereinigen,
+    // auch wenn ihre Streams gemeinsame Elemente haben.
+    [[nodiscard]] auto seed() const noexcept -> std::uint64_t
+        requires(Mode == Priorities::hashed)
+    {
+        return seed_;
+    }
 
-        // Generiere eine neue priority für den Heap
-        const auto u = TreapType::generate_prio();
+    // Erzeugt einen leeren Sketch mit demselben Seed (und damit denselben Prioritäten), z.B. für einen weiteren Shard.
+    [[nodiscard]] auto empty_copy() const noexcept -> KnuthSketch
+        requires(Mode == Priorities::hashed)
+    {
+        auto copy = KnuthSketch(s_, rng_);
+        copy.seed_ = seed_;
+        return copy;
+    }
 
-        if(u >= p) {
-            // Neue prio größer als p -> tue nichts
-            continue;
+    // Verarbeitet einen Block von Elementen in Stream-Reihenfolge, mit demselben Ergebnis wie add() für jedes Element.
+    // Bei zufälligen Prioritäten wird der Block in Stücke von prefetch_chunk Elementen geteilt. Ist der Puffer so groß,
+    // dass er kaum noch im Cache liegt, werden vor jedem Stück dessen Suchpfade im Puffer vorab geladen
+    // (siehe Treap::prefetch bzw. IndexedHeap::prefetch), danach folgen die Updates einzeln und in Reihenfolge.
+    // Bei Priorities::hashed scheitern die meisten Elemente schon am Vergleich mit p, dort lohnt sich das nicht.
+    auto add_batch(std::span<const T> elems) noexcept -> void
+    {
+        if constexpr(Mode == Priorities::random) {
+            for(std::size_t offset = 0; offset < elems.size(); offset += prefetch_chunk) {
+                const auto chunk = elems.subspan(offset, std::min(prefetch_chunk, elems.size() - offset));
+                if(buffer_.size() >= prefetch_min_size) {
+                    buffer_.prefetch(chunk);
+                }
+                for(const auto& elem : chunk) {
+                    add(elem);
+                }
+            }
+        } else {
+            for(const auto& elem : elems) {
+                add(elem);
+            }
         }
+    }
 
-        // Wenn Treap kleiner als s kann das Element mit prio u eingefügt werden
-        if(B.size() < s) {
-            B.insert(*it, u);
-            continue;
+    // Setzt den Sketch auf den Zustand nach einem Stream, dessen verschiedene Elemente genau 'distinct' sind
+    // (höchstens s, ohne Wiederholungen). Solange der Puffer nicht voll war, ist p = 1 und jedes Element hat die
+    // Priorität seines letzten Vorkommens, unabhängig vom Rest des Streams. Neu gezogene Prioritäten haben daher
+    // dieselbe Verteilung, bei Priorities::hashed sind sie ohnehin gleich. Der Puffer wird sortiert in O(s) aufgebaut.
+    auto assign_distinct(std::span<const T> distinct) -> void
+    {
+        std::vector<std::pair<T, double>> items;
+        items.reserve(distinct.size());
+        for(const auto& elem : distinct) {
+            if constexpr(Mode == Priorities::hashed) {
+                items.emplace_back(elem, priority(elem));
+            } else {
+                items.emplace_back(elem, uniform01(rng_));
+            }
         }
+        std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
-        // Top Element im Heap anschauen
-        // .top gibt den Root i Treap zurück
-        // .value() entpackt das optional von std::optional<std::pair<K, P>> zu std::pair<K,P>
-        const auto [a_prime, u_prime] = B.top().value();
+        p_ = 1;
+        buffer_.assign_sorted(items);
+        reserve(distinct.size());
+    }
 
-        if(u >= u_prime) {
-            p = u;
+    // Vereinigt den Sketch mit 'other', als wäre der Stream von 'other' nach dem eigenen verarbeitet worden.
+    // Das Ergebnis ist der Zustand, den ein einzelner Durchlauf mit denselben Prioritäten erreicht hätte:
+    // Die neue Schwelle ist das kleinere p, für Schlüssel in beiden Sketches gilt die Priorität aus 'other'
+    // und anschließend werden die größten Prioritäten verdrängt, bis höchstens s Elemente übrig sind.
+    // 'other' darf eine andere Puffergröße haben, es gilt immer die eigene.
+    //
+    // Exakt ist das nur, wenn ein Schlüssel, der in beiden Streams vorkommt, in beiden Sketches dieselbe Priorität hat
+    // (Priorities::hashed mit gleichem Seed, siehe empty_copy) oder die Streams disjunkte Schlüsselmengen haben
+    // (z.B. nach Hash partitioniert). Bei zufälligen Prioritäten und überlappenden Streams gibt es diese Garantie nicht,
+    // das Ergebnis hängt aber nicht vom Puffer-Container ab.
+    auto merge(const KnuthSketch& other) noexcept -> void
+    {
+        p_ = std::min(p_, other.p_);
+
+        // Eigene Elemente, die über der neuen Schwelle liegen, fallen heraus.
+        while(!buffer_.empty() && buffer_.top()->second >= p_) {
+            buffer_.pop();
+        }
+
+        // Elemente aus 'other' ersetzen gleiche eigene Schlüssel. Ein Treap vereinigt beide Puffer in einem Durchgang
+        // (siehe Treap::unite), danach fallen die übernommenen Elemente über der Schwelle wieder heraus.
+        if constexpr(requires { buffer_.unite(other.buffer_); }) {
+            buffer_.unite(other.buffer_);
+            while(!buffer_.empty() && buffer_.top()->second >= p_) {
+                buffer_.pop();
+            }
         } else {
-            // Top Element wird aus dem Heap gelöscht
-            B.pop();
+            other.buffer_.for_each([this](const T& elem, double prio) {
+                buffer_.delete_elem(elem);
+                if(prio < p_) {
+                    buffer_.insert(elem, prio);
+                }
+            });
+        }
 
-            // Neues Element wird eingefügt
-            B.insert(*it, u);
+        // Ist der Puffer zu groß, werden die größten Prioritäten verdrängt und p sinkt auf die zuletzt verdrängte.
+        while(buffer_.size() > s_) {
+            p_ = buffer_.pop()->second;
+        }
+    }
+
+    // Schätzt die Anzahl der Elemente, die in beiden Streams vorkommen, im Modus Priorities::hashed mit gleichem Seed.
+    // Die Vereinigung beider Sketches ist eine Stichprobe aller Elemente mit Priorität unter ihrer Schwelle p.
+    // Ein Element der Schnittmenge mit einer solchen Priorität steht wegen der festen Prioritäten in beiden Puffern,
+    // daher ist (Anzahl dieser Elemente) / p eine Schätzung der Schnittmenge.
+    [[nodiscard]] auto intersection_estimate(const KnuthSketch& other) const noexcept -> double
+        requires(Mode == Priorities::hashed) && requires(BufferType buffer) { buffer.intersect(buffer); }
+    {
+        auto both = *this;
+        both.merge(other);
+        both.buffer_.intersect(buffer_);
+        both.buffer_.intersect(other.buffer_);
+        return both.estimate();
+    }
 
-            // p wird upgedated auf die Prio des gelöschten Top Elements
-            p = u_prime;
+    // Schreibt den Zustand (s, p, Seed und gepufferte Elemente) in das kompakte Binärformat aus serialize.hpp.
+    // Die Schlüssel werden sortiert mit Differenzen als Varint abgelegt, zufällige Prioritäten auf 32 Bit quantisiert.
+    // Beim Treap liefert der Durchlauf die Schlüssel bereits sortiert und das Schreiben kostet O(s).
+    // Der Zustand des Generators wird nicht gespeichert.
+    [[nodiscard]] auto serialize() const -> std::vector<std::byte>
+        requires std::integral<T>
+    {
+        std::vector<std::pair<T, double>> items;
+        items.reserve(buffer_.size());
+        buffer_.for_each([&items](const T& elem, double prio) { items.emplace_back(elem, prio); });
+        if(!std::is_sorted(items.begin(), items.end())) {
+            std::sort(items.begin(), items.end());
         }
+
+        std::vector<std::byte> out;
+        out.reserve(serial::header_size + items.size() * (sizeof(T) + 5));
+        serial::Writer writer(out);
+        writer.bytes(serial::magic);
+        writer.fixed(serial::version);
+        writer.fixed(static_cast<std::uint8_t>(sizeof(T)));
+        writer.fixed(static_cast<std::uint8_t>(Mode == Priorities::hashed));
+        writer.fixed(static_cast<std::uint8_t>(std::is_signed_v<T>));
+        writer.fixed(static_cast<std::uint64_t>(s_));
+        writer.fixed(std::bit_cast<std::uint64_t>(p_));
+        writer.fixed(static_cast<std::uint64_t>(items.size()));
+        writer.fixed(seed_);
+
+        std::uint64_t prev = 0;
+        for(const auto& [elem, prio] : items) {
+            const auto key = serial::to_ordered(elem);
+            writer.varint(key - prev);
+            prev = key;
+        }
+
+        if constexpr(Mode == Priorities::random) {
+            for(const auto& [elem, prio] : items) {
+                writer.fixed(serial::quantize(prio, p_));
+            }
+        }
+
+        return out;
     }
 
-    return B.size() / p;
+    // Stellt einen mit serialize geschriebenen Sketch wieder her. Gibt std::nullopt zurück, wenn die Daten abgeschnitten
+    // oder ungültig sind oder nicht zu T und Mode passen. Der Puffer wird aus der sortierten Folge in O(s) aufgebaut
+    // (siehe Treap::assign_sorted). Neue Prioritäten werden danach aus 'rng' gezogen.
+    [[nodiscard]] static auto deserialize(std::span<const std::byte> bytes, Rng rng = Rng{random_seed()})
+        -> std::optional<KnuthSketch>
+        requires std::integral<T>
+    {
+        serial::Reader reader(bytes);
+        const auto magic = reader.bytes(serial::magic.size());
+        const auto version = reader.fixed<std::uint8_t>();
+        const auto width = reader.fixed<std::uint8_t>();
+        const auto hashed = reader.fixed<std::uint8_t>();
+        const auto is_signed = reader.fixed<std::uint8_t>();
+        const auto s = reader.fixed<std::uint64_t>();
+        const auto p_bits = reader.fixed<std::uint64_t>();
+        const auto n = reader.fixed<std::uint64_t>();
+        const auto seed = reader.fixed<std::uint64_t>();
+        // Die Felder werden nacheinander gelesen: Ist der Kopf abgeschnitten, fehlt spätestens der Seed.
+        // clang-format off
+        if(!seed || !std::equal(magic->begin(), magic->end(), serial::magic.begin())) return std::nullopt;
+        if(*version != serial::version || *width != sizeof(T) || *is_signed != std::is_signed_v<T>) return std::nullopt;
+        if(*hashed != (Mode == Priorities::hashed)) return std::nullopt;
+        // clang-format on
+
+        // Der Puffer enthält nie mehr als s Elemente, und jedes braucht mindestens ein Byte.
+        const auto p = std::bit_cast<double>(*p_bits);
+        // clang-format off
+        if(!(p > 0 && p <= 1) || *n > *s || *n > reader.remaining()) return std::nullopt;
+        // clang-format on
+
+        std::vector<std::pair<T, double>> items(*n);
+        // Die Schlüssel müssen streng aufsteigen und im Wertebereich von T bleiben.
+        constexpr std::uint64_t max_key = std::numeric_limits<std::make_unsigned_t<T>>::max();
+        std::uint64_t key = 0;
+        for(std::size_t i = 0; i < items.size(); i++) {
+            const auto delta = reader.varint();
+            // clang-format off
+            if(!delta || (i > 0 && *delta == 0) || *delta > max_key - key) return std::nullopt;
+            // clang-format on
+            key += *delta;
+            items[i].first = serial::from_ordered<T>(key);
+        }
+
+        KnuthSketch sketch(static_cast<std::size_t>(*s), std::move(rng));
+        sketch.p_ = p;
+        sketch.seed_ = *seed;
+        for(auto& [elem, prio] : items) {
+            if constexpr(Mode == Priorities::hashed) {
+                prio = sketch.priority(elem);
+                // clang-format off
+                if(prio >= p) return std::nullopt;
+                // clang-format on
+            } else {
+                const auto q = reader.fixed<std::uint32_t>();
+                // clang-format off
+                if(!q) return std::nullopt;
+                // clang-format on
+                prio = serial::dequantize(*q, p);
+            }
+        }
+        // clang-format off
+        if(reader.remaining() != 0) return std::nullopt;
+        // clang-format on
+
+        sketch.buffer_.assign_sorted(items);
+        return sketch;
+    }
+
+    // Aktuelle Schätzung der Anzahl verschiedener Elemente.
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return buffer_.size() / p_;
+    }
+
+    // Aktuelle Schwelle p, unter der die Prioritäten der gepufferten Elemente liegen.
+    [[nodiscard]] auto probability() const noexcept -> double
+    {
+        return p_;
+    }
+
+    // Anzahl der gepufferten Elemente.
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return buffer_.size();
+    }
+
+    // Maximale Anzahl gepufferter Elemente.
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return s_;
+    }
+
+private:
+    // Anzahl der Elemente, deren Suchpfade in add_batch gemeinsam vorab geladen werden.
+    constexpr static std::size_t prefetch_chunk = 32;
+
+    // Ab dieser Puffergröße wird in add_batch vorab geladen. Darunter liegt der Puffer ohnehin im L2-Cache.
+    constexpr static std::size_t prefetch_min_size = std::size_t{1} << 14;
+
+    BufferType buffer_;      // Gepufferte Elemente mit ihren Prioritäten.
+    std::size_t s_;          // Puffergröße.
+    double p_ = 1;           // Alle gepufferten Prioritäten liegen unter p.
+    Rng rng_;                // Quelle der Prioritäten.
+    std::uint64_t seed_ = 0; // Seed des Hashs, nur im Modus Priorities::hashed.
+};
+
+// Knuth Version des CVM-Algorithmus
+// Buffer wählt den Container des Puffers (SlabTreap, IndexTreap oder IndexedHeap, siehe KnuthSketch).
+// Die Prioritäten werden aus 'rng' gezogen. Mit einem festen Seed, z.B. WyRand{42}, ist das Ergebnis reproduzierbar.
+// Mode wählt, woher die Prioritäten kommen (siehe Priorities).
+// Für Schlüssel mit höchstens 16 Bit (NarrowKey) wird exakt gezählt (siehe bitmap_count).
+template<template<class, class> class Buffer = SlabTreap, Priorities Mode = Priorities::random, class Iter,
+         std::uniform_random_bit_generator Rng = WyRand>
+[[nodiscard]] static auto knuth_cvm(Iter begin, Iter end, std::size_t s, Rng rng = Rng{random_seed()}) noexcept
+    -> std::optional<double>
+{
+    // Typ der Elemente des Streams
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    // Bei Schlüsseln mit höchstens 16 Bit ist die exakte Zählung in einer Bitmap schneller als jede Stichprobe.
+    if constexpr(NarrowKey<ItemType>) {
+        return bitmap_count(begin, end);
+    } else {
+        KnuthSketch<ItemType, Buffer, Mode, Rng> sketch(s, std::move(rng));
+
+        // Der Treap enthält nie mehr als s Elemente, daher werden die Knoten einmalig für s Elemente angelegt.
+        // Bei Random-Access-Iteratoren genügt die Länge des Streams, falls diese kleiner ist.
+        auto capacity = s;
+        if constexpr(std::random_access_iterator<Iter>) {
+            capacity = std::min(s, static_cast<std::size_t>(std::distance(begin, end)));
+        }
+        sketch.reserve(capacity);
+
+        // Iteriere über die Elemente des Streams. Liegen sie zusammenhängend im Speicher, geht es blockweise mit Prefetching.
+        if constexpr(std::contiguous_iterator<Iter>) {
+            sketch.add_batch(std::span<const ItemType>(std::to_address(begin), static_cast<std::size_t>(end - begin)));
+        } else {
+            for(auto it = begin; it != end; ++it) {
+                sketch.add(*it);
+            }
+        }
+
+        return sketch.estimate();
+    }
 }
 
 } // namespace cvm
@@ -7,12 +7,20 @@
 #include <iterator>
 #include <optional>
 #include <random>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include <cvm/bitmap.hpp>
+#include <cvm/flat_set.hpp>
+#include <cvm/random.hpp>
+
 namespace cvm {
 
 // Die Funktion random_sample verwendet den übergebenen Wahrscheinlichkeitswert p, um eine zufällige Entscheidung zu treffen und true oder false zurückzugeben, wobei die Wahrscheinlichkeit von true gleich p ist.
-[[nodiscard]] inline auto random_sample(double p) noexcept -> bool
+// Die Zufallsbits stammen aus dem übergebenen Generator.
+template<std::uniform_random_bit_generator Rng>
+[[nodiscard]] inline auto random_sample(double p, Rng& rng) noexcept -> bool
 {
     // Wenn p kleiner als 0 ist, gibt die Funktion sofort 'false' zurück.
     if(p < 0.0) [[unlikely]] {
@@ -24,56 +32,276 @@ namespace cvm {
         return true;
     }
 
-    static std::mt19937 gen(std::random_device{}());
-    static std::uniform_real_distribution<> dist(0.0, 1.0);
+    return uniform01(rng) < p;
+}
 
-    return dist(gen) < p;
+// Wie random_sample(p, rng), aber mit dem Generator des aufrufenden Threads.
+[[nodiscard]] inline auto random_sample(double p) noexcept -> bool
+{
+    return random_sample(p, default_rng());
 }
 
-template<class Iter>
-[[nodiscard]] static auto naive_cvm(Iter begin, Iter end, double EPSILON, double DELTA) noexcept
-    -> std::optional<double>
+// Art, wie die Zufallsentscheidungen in naive_cvm gezogen werden.
+enum class Sampling {
+    // Eine Zufallszahl pro Element und eine pro Münzwurf beim Halbieren.
+    bernoulli,
+    // Geometrische Sprünge zwischen den Elementen, die behalten werden, und 64 Münzwürfe pro Zufallszahl beim Halbieren.
+    // Gleiche Verteilung wie bernoulli, aber bei kleinem p nur noch etwa p * n Zufallszahlen für n Elemente.
+    geometric,
+};
+
+// Zustandsbehafteter Sketch für die naive Version des CVM-Algorithmus.
+// Die Elemente können einzeln oder blockweise hinzugefügt werden, die Schätzung ist jederzeit abrufbar.
+// Der Schwellenwert hängt von der Länge des Streams ab. Ist eine obere Schranke bekannt, wird er einmalig daraus berechnet.
+// Ohne Schranke wird mit einer kleinen Annahme begonnen, die verdoppelt wird, sobald der Stream sie übersteigt.
+// Dabei wird auch DELTA für jede Phase halbiert, sodass die Fehlerwahrscheinlichkeit über alle Phasen höchstens DELTA bleibt.
+// Da der Schwellenwert dabei nur wächst, bleibt der bisherige Zustand gültig.
+// Mode wählt, wie die Zufallsentscheidungen gezogen werden (siehe Sampling).
+template<class T, Sampling Mode = Sampling::geometric, std::uniform_random_bit_generator Rng = WyRand>
+class NaiveSketch
 {
-    // Ermitteln des Datentyps der Elemente im übergebenen Stream.
-    using ItemType = typename std::iterator_traits<Iter>::value_type;
+public:
+    // Erzeugt einen Sketch für einen Stream mit höchstens 'max_len' Elementen.
+    // Die Zufallsentscheidungen werden aus 'rng' gezogen. Mit einem festen Seed, z.B. WyRand{42}, ist das Ergebnis reproduzierbar.
+    NaiveSketch(double EPSILON, double DELTA, std::size_t max_len, Rng rng = Rng{random_seed()}) noexcept
+        : epsilon_(EPSILON),
+          delta_(DELTA),
+          bound_(max_len),
+          doubling_(false),
+          rng_(std::move(rng))
+    {
+        set_threshold(threshold_for(epsilon_, delta_, bound_));
+    }
 
-    // Bestimmt die Anzahl der Elemente im Stream.
-    const auto number_of_elements = std::distance(begin, end);
+    // Erzeugt einen Sketch für einen Stream unbekannter Länge (Verdopplungsschema).
+    explicit NaiveSketch(double EPSILON, double DELTA, Rng rng = Rng{random_seed()}) noexcept
+        : epsilon_(EPSILON),
+          delta_(DELTA),
+          bound_(initial_bound),
+          doubling_(true),
+          rng_(std::move(rng))
+    {
+        set_threshold(threshold_for(epsilon_, phase_delta(), bound_));
+    }
 
-    // Berechnung des treshs
-    const std::size_t THRESHOLD = (12. / EPSILON * EPSILON) * std::log2((8 * number_of_elements) / DELTA);
-    // Initialisierung von p und X
-    double p = 1;
-    std::vector<ItemType> X;
+    // Verarbeitet ein Element des Streams.
+    // Gibt false zurück, wenn der Algorithmus gescheitert ist; weitere Elemente werden dann ignoriert.
+    auto add(const T& elem) noexcept -> bool
+    {
+        // clang-format off
+        if(failed_) return false;
+        // clang-format on
 
-    // Iteriere über die Elemente des Streams
-    for(auto it = begin; it != end; ++it) {
+        // Übersteigt der Stream die angenommene Länge, wird sie verdoppelt und der Schwellenwert angehoben.
+        if(doubling_ && ++seen_ > bound_) [[unlikely]] {
+            bound_ *= 2;
+            phase_++;
+            set_threshold(threshold_for(epsilon_, phase_delta(), bound_));
+        }
 
         // Lösche das neue Element aus X
-        std::erase(X, *it);
+        X_.erase(elem);
 
         // Mit Wahrscheinlichkeit p wird das Element wieder eingefügt
-        if(random_sample(p)) {
-            X.emplace_back(*it);
+        bool keep;
+        if constexpr(Mode == Sampling::geometric) {
+            keep = sampler_(rng_);
+        } else {
+            keep = random_sample(p_, rng_);
+        }
+
+        if(keep) {
+            X_.insert(elem);
         }
 
         // Überprüfen, ob die Größe von X den festgelegten Schwellenwert erreicht oder überschreitet.
-        if(X.size() >= THRESHOLD) {
+        if(X_.size() >= threshold_) {
 
-            // Entfernt jedes Element in X mit einer Wahrscheinlichkeit von 0.5.
-            std::erase_if(X, [p](auto /*_*/) { return random_sample(0.5); });
+            // Entfernt jedes Element in X mit einer Wahrscheinlichkeit von 0.5 in einem Durchlauf über die Tabelle.
+            if constexpr(Mode == Sampling::geometric) {
+                CoinFlips coins;
+                X_.erase_if([&](const auto& /*_*/) { return coins(rng_); });
+            } else {
+                X_.erase_if([this](const auto& /*_*/) { return random_sample(0.5, rng_); });
+            }
 
             // Aktualisieren von p auf die Hälfte seines aktuellen Werts.
-            p /= 2;
+            p_ /= 2;
 
-            // Überprüfen, ob die Größe von X immer noch über dem Schwellenwert liegt; falls ja, wird ein Error zurückgeben.
-            if(X.size() >= THRESHOLD) {
-                return std::nullopt;
+            if constexpr(Mode == Sampling::geometric) {
+                sampler_.set_probability(p_, rng_);
+            }
+
+            // Überprüfen, ob die Größe von X immer noch über dem Schwellenwert liegt; falls ja, ist der Algorithmus gescheitert.
+            if(X_.size() >= threshold_) {
+                failed_ = true;
+                return false;
             }
         }
+
+        return true;
     }
 
-    return X.size() / p;
+    // Verarbeitet einen Block von Elementen in Stream-Reihenfolge.
+    // Gibt false zurück, wenn der Algorithmus gescheitert ist.
+    auto add_batch(std::span<const T> elems) noexcept -> bool
+    {
+        for(const auto& elem : elems) {
+            // clang-format off
+            if(!add(elem)) return false;
+            // clang-format on
+        }
+        return true;
+    }
+
+    // Vereinigt den Sketch mit 'other', als wäre der Stream von 'other' nach dem eigenen verarbeitet worden.
+    // Beide Puffer werden auf das kleinere p ausgedünnt (jedes Element bleibt mit Wahrscheinlichkeit p / p_alt),
+    // vereinigt und so oft halbiert, bis der Puffer wieder unter dem Schwellenwert liegt.
+    // Wie bei KnuthSketch::merge ist das Ergebnis nur exakt, wenn die Streams disjunkte Schlüsselmengen haben;
+    // ein gemeinsamer Schlüssel hat sonst zwei Chancen, im Puffer zu landen.
+    // Gibt false zurück, wenn einer der beiden Sketches gescheitert ist.
+    auto merge(const NaiveSketch& other) noexcept -> bool
+    {
+        if(failed_ || other.failed_) {
+            failed_ = true;
+            return false;
+        }
+
+        // Im Verdopplungsschema wächst die angenommene Länge mit der Summe beider Streams.
+        if(doubling_) {
+            seen_ += other.seen_;
+            while(seen_ > bound_) {
+                bound_ *= 2;
+                phase_++;
+            }
+            set_threshold(std::max(threshold_, threshold_for(epsilon_, phase_delta(), bound_)));
+        }
+
+        const auto p = std::min(p_, other.p_);
+        if(p < p_) {
+            const auto keep = p / p_;
+            X_.erase_if([&](const auto& /*_*/) { return !random_sample(keep, rng_); });
+        }
+
+        const auto keep = p / other.p_;
+        other.X_.for_each([&](const T& elem) {
+            if(random_sample(keep, rng_)) {
+                X_.insert(elem);
+            }
+        });
+        p_ = p;
+
+        // Halbieren, bis der Puffer wieder unter dem Schwellenwert liegt.
+        while(!X_.empty() && X_.size() >= threshold_) {
+            CoinFlips coins;
+            X_.erase_if([&](const auto& /*_*/) { return coins(rng_); });
+            p_ /= 2;
+        }
+
+        if constexpr(Mode == Sampling::geometric) {
+            sampler_.set_probability(p_, rng_);
+        }
+
+        return true;
+    }
+
+    // Aktuelle Schätzung der Anzahl verschiedener Elemente oder std::nullopt, wenn der Algorithmus gescheitert ist.
+    [[nodiscard]] auto estimate() const noexcept -> std::optional<double>
+    {
+        // clang-format off
+        if(failed_) return std::nullopt;
+        // clang-format on
+
+        return X_.size() / p_;
+    }
+
+    // Aktuelle Wahrscheinlichkeit, mit der ein Element im Puffer gehalten wird.
+    [[nodiscard]] auto probability() const noexcept -> double
+    {
+        return p_;
+    }
+
+    // Anzahl der gepufferten Elemente.
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return X_.size();
+    }
+
+    // Aktueller Schwellenwert für die Größe des Puffers.
+    [[nodiscard]] auto threshold() const noexcept -> std::size_t
+    {
+        return threshold_;
+    }
+
+    // Berechnung des treshs für einen Stream mit höchstens 'len' Elementen.
+    [[nodiscard]] static auto threshold_for(double EPSILON, double DELTA, std::size_t len) noexcept -> std::size_t
+    {
+        const auto n = static_cast<double>(std::max<std::size_t>(len, 1));
+        return static_cast<std::size_t>((12. / EPSILON * EPSILON) * std::log2((8 * n) / DELTA));
+    }
+
+private:
+    // Angenommene Länge des Streams zu Beginn des Verdopplungsschemas.
+    constexpr static std::size_t initial_bound = 1024;
+
+    // Fehlerwahrscheinlichkeit der aktuellen Phase im Verdopplungsschema: DELTA / 2^(phase + 1).
+    [[nodiscard]] auto phase_delta() const noexcept -> double
+    {
+        return std::ldexp(delta_, -static_cast<int>(phase_ + 1));
+    }
+
+    // Setzt einen neuen (nicht kleineren) Schwellenwert und vergrößert X so, dass es ohne Rehash hineinpasst.
+    auto set_threshold(std::size_t thresh) noexcept -> void
+    {
+        threshold_ = thresh;
+        X_.reserve(threshold_);
+    }
+
+private:
+    // X ist ein Hashset, damit Löschen und Einfügen erwartet O(1) statt O(THRESHOLD) kosten.
+    FlatSet<T> X_;
+    double p_ = 1;                // Wahrscheinlichkeit, mit der ein Element in X gehalten wird.
+    std::size_t threshold_ = 0;   // Schwellenwert für die Größe von X.
+    double epsilon_;              // Gewünschte relative Genauigkeit.
+    double delta_;                // Gewünschte Fehlerwahrscheinlichkeit.
+    std::size_t bound_;           // Angenommene obere Schranke der Stream-Länge.
+    std::size_t seen_ = 0;        // Anzahl der bisher gesehenen Elemente (nur im Verdopplungsschema).
+    std::size_t phase_ = 0;       // Anzahl der bisherigen Verdopplungen.
+    bool doubling_;               // true, wenn die Stream-Länge unbekannt ist.
+    bool failed_ = false;         // true, wenn X nach dem Halbieren noch zu groß war.
+    GeometricSampler sampler_;    // Entscheidet, ob ein Element behalten wird (nur im geometrischen Modus).
+    Rng rng_;                     // Quelle der Zufallsentscheidungen.
+};
+
+// Naive Version des CVM-Algorithmus.
+// Die Zufallsentscheidungen werden aus 'rng' gezogen. Mit einem festen Seed, z.B. WyRand{42}, ist das Ergebnis reproduzierbar.
+// Mode wählt, wie die Zufallsentscheidungen gezogen werden (siehe Sampling).
+// Für Schlüssel mit höchstens 16 Bit (NarrowKey) wird exakt gezählt (siehe bitmap_count).
+template<Sampling Mode = Sampling::geometric, class Iter, std::uniform_random_bit_generator Rng = WyRand>
+[[nodiscard]] static auto naive_cvm(Iter begin, Iter end, double EPSILON, double DELTA, Rng rng = Rng{random_seed()}) noexcept
+    -> std::optional<double>
+{
+    // Ermitteln des Datentyps der Elemente im übergebenen Stream.
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    // Bei Schlüsseln mit höchstens 16 Bit ist die exakte Zählung in einer Bitmap schneller als jede Stichprobe.
+    if constexpr(NarrowKey<ItemType>) {
+        return bitmap_count(begin, end);
+    } else {
+        // Bestimmt die Anzahl der Elemente im Stream, sie dient als obere Schranke für den Schwellenwert.
+        const auto number_of_elements = static_cast<std::size_t>(std::distance(begin, end));
+
+        NaiveSketch<ItemType, Mode, Rng> sketch(EPSILON, DELTA, number_of_elements, std::move(rng));
+
+        // Iteriere über die Elemente des Streams
+        for(auto it = begin; it != end; ++it) {
+            if(!sketch.add(*it)) {
+                return std::nullopt;
+            }
+        }
+
+        return sketch.estimate();
+    }
 }
 
 } // namespace cvm
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <cvm/hash.hpp>
+
+namespace cvm {
+
+// Hashset mit offener Adressierung (lineares Sondieren) in einem zusammenhängenden Array.
+// Gelöscht wird per Backward-Shift, daher gibt es keine Grabsteine und die Sondierketten bleiben kurz.
+// Die Tabelle ist höchstens zur Hälfte gefüllt.
+template<class K, class H = Hash<K>>
+class FlatSet
+{
+public:
+    // Erzeugt ein leeres Set, das 'capacity' Elemente ohne Rehash aufnehmen kann.
+    explicit FlatSet(std::size_t capacity = 0) noexcept
+    {
+        reserve(capacity);
+    }
+
+    // Fügt ein Element ein. Gibt false zurück, wenn es bereits enthalten war.
+    auto insert(const K& elem) noexcept -> bool
+    {
+        if(2 * (size_ + 1) > slots_.size()) {
+            reserve(size_ + 1);
+        }
+
+        auto idx = home(elem);
+        while(used_[idx]) {
+            if(slots_[idx] == elem) {
+                return false;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        place(idx, elem);
+        return true;
+    }
+
+    // Entfernt ein Element. Gibt false zurück, wenn es nicht enthalten war.
+    auto erase(const K& elem) noexcept -> bool
+    {
+        // clang-format off
+        if(size_ == 0) return false;
+        // clang-format on
+
+        auto idx = home(elem);
+        while(used_[idx]) {
+            if(slots_[idx] == elem) {
+                remove_at(idx);
+                return true;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        return false;
+    }
+
+    // Überprüft, ob ein Element im Set enthalten ist.
+    [[nodiscard]] auto contains(const K& elem) const noexcept -> bool
+    {
+        // clang-format off
+        if(size_ == 0) return false;
+        // clang-format on
+
+        auto idx = home(elem);
+        while(used_[idx]) {
+            if(slots_[idx] == elem) {
+                return true;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        return false;
+    }
+
+    // Entfernt alle Elemente, für die 'pred' true liefert, in einem einzigen Durchlauf über die Tabelle.
+    // Jedes Element wird dabei herausgenommen und, falls es bleibt, neu einsortiert.
+    // Da der Durchlauf an einem freien Slot beginnt, landet jedes Element höchstens an seiner alten Position
+    // und die Sondierketten bleiben gültig. 'pred' wird genau einmal pro Element aufgerufen.
+    template<class Pred>
+    auto erase_if(Pred pred) noexcept -> std::size_t
+    {
+        // clang-format off
+        if(size_ == 0) return 0;
+        // clang-format on
+
+        std::size_t start = 0;
+        while(used_[start]) {
+            ++start;
+        }
+
+        const auto old_size = size_;
+        for(std::size_t i = 1; i <= mask_; i++) {
+            const auto idx = (start + i) & mask_;
+            if(!used_[idx]) {
+                continue;
+            }
+
+            auto elem = std::move(slots_[idx]);
+            used_[idx] = 0;
+            size_--;
+
+            if(pred(std::as_const(elem))) {
+                continue;
+            }
+
+            auto pos = home(elem);
+            while(used_[pos]) {
+                pos = (pos + 1) & mask_;
+            }
+            place(pos, std::move(elem));
+        }
+
+        return old_size - size_;
+    }
+
+    // Ruft 'f' für jedes Element auf (in Tabellenreihenfolge).
+    template<class F>
+    auto for_each(F f) const noexcept -> void
+    {
+        for(std::size_t i = 0; i < slots_.size(); i++) {
+            if(used_[i]) {
+                f(slots_[i]);
+            }
+        }
+    }
+
+    // Vergrößert die Tabelle, sodass 'capacity' Elemente bei Lastfaktor <= 1/2 Platz haben.
+    auto reserve(std::size_t capacity) noexcept -> void
+    {
+        const auto needed = std::bit_ceil(std::max<std::size_t>(2 * capacity, 8));
+        // clang-format off
+        if(needed <= slots_.size()) return;
+        // clang-format on
+
+        auto old_slots = std::exchange(slots_, std::vector<K>(needed));
+        auto old_used = std::exchange(used_, std::vector<std::uint8_t>(needed, 0));
+        mask_ = needed - 1;
+        size_ = 0;
+
+        for(std::size_t i = 0; i < old_slots.size(); i++) {
+            if(old_used[i]) {
+                auto pos = home(old_slots[i]);
+                while(used_[pos]) {
+                    pos = (pos + 1) & mask_;
+                }
+                place(pos, std::move(old_slots[i]));
+            }
+        }
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return size_;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return size_ == 0;
+    }
+
+    // Leert das Set, die Tabelle bleibt allokiert.
+    auto clear() noexcept -> void
+    {
+        std::fill(used_.begin(), used_.end(), 0);
+        size_ = 0;
+    }
+
+private:
+    // Startposition der Sondierkette eines Schlüssels.
+    [[nodiscard]] auto home(const K& elem) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(H{}(elem)) & mask_;
+    }
+
+    template<class T>
+    auto place(std::size_t idx, T&& elem) noexcept -> void
+    {
+        slots_[idx] = std::forward<T>(elem);
+        used_[idx] = 1;
+        size_++;
+    }
+
+    // Backward-Shift-Löschung: Nachfolgende Elemente der Sondierkette rücken nach,
+    // sofern ihre Startposition das erlaubt.
+    auto remove_at(std::size_t hole) noexcept -> void
+    {
+        auto idx = (hole + 1) & mask_;
+        while(used_[idx]) {
+            const auto h = home(slots_[idx]);
+
+            // Das Element darf nur nach 'hole' wandern, wenn 'hole' zyklisch zwischen h und idx liegt.
+            if(((idx - h) & mask_) >= ((idx - hole) & mask_)) {
+                slots_[hole] = std::move(slots_[idx]);
+                hole = idx;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        used_[hole] = 0;
+        size_--;
+    }
+
+private:
+    std::vector<K> slots_;           // Schlüssel der Slots.
+    std::vector<std::uint8_t> used_; // Belegt-Markierung pro Slot.
+    std::size_t mask_ = 0;           // Tabellengröße - 1 (Tabellengröße ist eine Zweierpotenz).
+    std::size_t size_ = 0;           // Anzahl der Elemente.
+};
+
+} // namespace cvm
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cvm/hash.hpp>
+#include <cvm/random.hpp>
+
+namespace cvm {
+
+// Viele kleine Knuth-Sketches mit Prioritäten aus einem Hash (Priorities::hashed), z.B. einer pro Mandant oder Endpunkt.
+// Die Gruppen werden über dichte Nummern 0 .. groups() - 1 angesprochen.
+//
+// Pro Gruppe liegen nur die 64-Bit-Prioritäten mix64(Hash(elem) ^ seed) im Puffer, aufsteigend sortiert: Bei gleichen
+// Prioritäten für gleiche Elemente ist der Puffer genau die Menge der höchstens s kleinsten Prioritäten unter der Schwelle,
+// die Elemente selbst werden nicht gebraucht (wie bei HashedSketch zählen Kollisionen der 64-Bit-Werte als ein Element).
+// Eine Gruppe belegt 32 Bytes mit Platz für inline_capacity Prioritäten. Wächst sie darüber hinaus, zieht ihr Puffer in
+// einen gemeinsamen Pool um und verdoppelt dort seine Kapazität bis s. Freigewordene Blöcke werden pro Größe wiederverwendet.
+// add_batch verteilt große Blöcke von (Gruppe, Element)-Paaren vorher per Radix-Partitionierung nach den oberen Bits der
+// Gruppennummer, damit die Gruppen eines Teils gemeinsam im Cache liegen. Da das Ergebnis bei festen Prioritäten
+// nicht von der Reihenfolge abhängt, ändert das nichts an den Schätzungen.
+template<class T, class H = Hash<T>>
+class GroupedSketches
+{
+public:
+    // Erzeugt 'groups' leere Sketches mit Puffergröße s (mindestens 1, höchstens 2^32 - 1) und dem Seed 'seed' für die
+    // Prioritäten.
+    GroupedSketches(std::size_t groups, std::size_t s, std::uint64_t seed = random_seed())
+        : groups_(groups),
+          s_(static_cast<std::uint32_t>(std::clamp<std::size_t>(s, 1, std::numeric_limits<std::uint32_t>::max()))),
+          seed_(seed)
+    {
+    }
+
+    // Verarbeitet ein Element der Gruppe 'group'. Wächst der Puffer der Gruppe, kann der Pool std::bad_alloc werfen.
+    auto add(std::uint32_t group, const T& elem) -> void
+    {
+        update(groups_[group], priority(elem));
+    }
+
+    // Verarbeitet die Paare (groups[i], elems[i]). Beide Bereiche müssen gleich lang sein. Wirft wie add.
+    auto add_batch(std::span<const std::uint32_t> groups, std::span<const T> elems) -> void
+    {
+        if(groups_.size() <= partition_min_groups || groups.size() < partition_min_items) {
+            for(std::size_t i = 0; i < groups.size(); i++) {
+                add(groups[i], elems[i]);
+            }
+            return;
+        }
+
+        // Ein Teil umfasst 2^shift aufeinanderfolgende Gruppen, insgesamt höchstens max_partitions Teile.
+        const auto bits = static_cast<unsigned>(std::bit_width(groups_.size() - 1));
+        const auto shift = bits > partition_bits ? bits - partition_bits : 0;
+        const auto parts = ((groups_.size() - 1) >> shift) + 1;
+
+        // Zählen, Präfixsummen, Verteilen: Die Prioritäten werden dabei gleich mitberechnet.
+        std::vector<std::size_t> offsets(parts + 1, 0);
+        for(const auto group : groups) {
+            offsets[(group >> shift) + 1]++;
+        }
+        for(std::size_t i = 0; i < parts; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+        scratch_.resize(groups.size());
+        for(std::size_t i = 0; i < groups.size(); i++) {
+            scratch_[offsets[groups[i] >> shift]++] = {groups[i], priority(elems[i])};
+        }
+
+        for(const auto& [group, prio] : scratch_) {
+            update(groups_[group], prio);
+        }
+    }
+
+    // Schätzung der Anzahl verschiedener Elemente in Gruppe 'group'.
+    [[nodiscard]] auto estimate(std::uint32_t group) const noexcept -> double
+    {
+        const auto& g = groups_[group];
+        return g.size / probability(g);
+    }
+
+    // Schätzungen aller Gruppen, Index = Gruppennummer.
+    [[nodiscard]] auto estimates() const -> std::vector<double>
+    {
+        std::vector<double> result(groups_.size());
+        for(std::size_t i = 0; i < groups_.size(); i++) {
+            result[i] = estimate(static_cast<std::uint32_t>(i));
+        }
+        return result;
+    }
+
+    // Anzahl der gepufferten Prioritäten in Gruppe 'group'.
+    [[nodiscard]] auto size(std::uint32_t group) const noexcept -> std::size_t
+    {
+        return groups_[group].size;
+    }
+
+    // Anzahl der Gruppen.
+    [[nodiscard]] auto groups() const noexcept -> std::size_t
+    {
+        return groups_.size();
+    }
+
+    // Puffergröße s jeder Gruppe.
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return s_;
+    }
+
+    // Belegter Speicher der Gruppen und des Pools in Bytes (ohne den Puffer für add_batch).
+    [[nodiscard]] auto memory_bytes() const noexcept -> std::size_t
+    {
+        return groups_.capacity() * sizeof(Group) + pool_.capacity() * sizeof(std::uint64_t);
+    }
+
+private:
+    // Anzahl der Prioritäten, die direkt in einer Gruppe Platz haben.
+    constexpr static std::uint32_t inline_capacity = 2;
+
+    // Bits der Gruppennummer, nach denen add_batch partitioniert (höchstens 1024 Teile).
+    constexpr static unsigned partition_bits = 10;
+
+    // Bei weniger Gruppen liegen ohnehin alle im Cache, bei kleineren Blöcken lohnt das Verteilen nicht.
+    constexpr static std::size_t partition_min_groups = std::size_t{1} << 14;
+    constexpr static std::size_t partition_min_items = std::size_t{1} << 12;
+
+    // Schwelle einer Gruppe, die noch nichts verdrängt hat (p = 1).
+    constexpr static std::uint64_t no_limit = std::numeric_limits<std::uint64_t>::max();
+
+    // Zustand eines Sketches. Ist capacity > inline_capacity, liegt der Puffer ab pool_[slots[0]].
+    struct Group
+    {
+        std::uint64_t limit = no_limit;                       // Alle gepufferten Prioritäten liegen darunter.
+        std::uint32_t size = 0;                               // Anzahl der gepufferten Prioritäten.
+        std::uint32_t capacity = inline_capacity;             // Platz im Puffer.
+        std::array<std::uint64_t, inline_capacity> slots{};   // Prioritäten oder Offset im Pool.
+    };
+    static_assert(sizeof(Group) == 32);
+
+    [[nodiscard]] auto priority(const T& elem) const noexcept -> std::uint64_t
+    {
+        return mix64(static_cast<std::uint64_t>(H{}(elem)) ^ seed_);
+    }
+
+    // p einer Gruppe als Anteil am Wertebereich der Prioritäten.
+    [[nodiscard]] static auto probability(const Group& g) noexcept -> double
+    {
+        return g.limit == no_limit ? 1.0 : static_cast<double>(g.limit) * 0x1p-64;
+    }
+
+    [[nodiscard]] auto data(Group& g) noexcept -> std::uint64_t*
+    {
+        return g.capacity <= inline_capacity ? g.slots.data() : pool_.data() + g.slots[0];
+    }
+
+    // Ein Schritt des Algorithmus wie in Treap::cvm_update_fixed, auf dem sortierten Puffer der Gruppe.
+    auto update(Group& g, std::uint64_t prio) -> void
+    {
+        // clang-format off
+        if(prio >= g.limit) return;
+        // clang-format on
+
+        auto* buffer = data(g);
+        auto* pos = std::lower_bound(buffer, buffer + g.size, prio);
+        // clang-format off
+        if(pos != buffer + g.size && *pos == prio) return;
+        // clang-format on
+
+        // Ist der Puffer voll, wird die größte Priorität verdrängt oder die neue wird selbst zur Schwelle.
+        if(g.size == s_) {
+            if(pos == buffer + g.size) {
+                g.limit = prio;
+                return;
+            }
+            g.limit = buffer[--g.size];
+        } else if(g.size == g.capacity) {
+            const auto index = pos - buffer;
+            grow(g);
+            buffer = data(g);
+            pos = buffer + index;
+        }
+
+        std::move_backward(pos, buffer + g.size, buffer + g.size + 1);
+        *pos = prio;
+        g.size++;
+    }
+
+    // Verdoppelt die Kapazität einer vollen Gruppe (höchstens s) und zieht ihren Puffer in einen Block des Pools um.
+    auto grow(Group& g) -> void
+    {
+        const auto capacity = std::min(2 * g.capacity, s_);
+        const auto offset = allocate(capacity);
+        std::copy_n(data(g), g.size, pool_.data() + offset);
+
+        if(g.capacity > inline_capacity) {
+            free_[size_class(g.capacity)].push_back(g.slots[0]);
+        }
+        g.capacity = capacity;
+        g.slots[0] = offset;
+    }
+
+    // Größenklasse eines Blocks. Alle Kapazitäten außer s sind Zweierpotenzen, s bekommt die Klasse der nächsten.
+    [[nodiscard]] static auto size_class(std::uint32_t capacity) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(std::bit_width(capacity - 1));
+    }
+
+    // Offset eines freien Blocks mit 'capacity' Einträgen.
+    auto allocate(std::uint32_t capacity) -> std::uint64_t
+    {
+        auto& list = free_[size_class(capacity)];
+        if(!list.empty()) {
+            const auto offset = list.back();
+            list.pop_back();
+            return offset;
+        }
+        const auto offset = pool_.size();
+        pool_.resize(pool_.size() + capacity);
+        return offset;
+    }
+
+    std::vector<Group> groups_;                                    // Zustand aller Sketches, Index = Gruppennummer.
+    std::vector<std::uint64_t> pool_;                              // Puffer der Gruppen, die nicht mehr inline passen.
+    std::array<std::vector<std::uint64_t>, 33> free_;              // Freie Blöcke im Pool pro Größenklasse.
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> scratch_; // Partitionierte Paare in add_batch.
+    std::uint32_t s_;                                              // Puffergröße.
+    std::uint64_t seed_;                                           // Seed der Prioritäten.
+};
+
+} // namespace cvm
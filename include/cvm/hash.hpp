@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace cvm {
+
+// Finalizer aus MurmurHash3 (fmix64). Verteilt die Bits eines 64-Bit-Wertes gleichmäßig,
+// sodass auch aufeinanderfolgende Schlüssel in einer Zweierpotenz-Tabelle gut streuen.
+[[nodiscard]] constexpr auto mix64(std::uint64_t x) noexcept -> std::uint64_t
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Multipliziert zwei 64-Bit-Werte zu 128 Bit und faltet beide Hälften per XOR zusammen (wie in wyhash).
+[[nodiscard]] constexpr auto mum(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t
+{
+    const auto product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product >> 64) ^ static_cast<std::uint64_t>(product);
+}
+
+// Hasht eine Bytefolge beliebiger Länge auf 64 Bit, angelehnt an wyhash.
+// Pro Runde werden 16 Bytes mit einer einzigen 128-Bit-Multiplikation verarbeitet, der Rest wird mit
+// überlappenden Lesezugriffen aufgefüllt, sodass nie über das Ende der Daten hinaus gelesen wird.
+[[nodiscard]] inline auto hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept -> std::uint64_t
+{
+    constexpr std::uint64_t secret0 = 0xa0761d6478bd642fULL;
+    constexpr std::uint64_t secret1 = 0xe7037ed1a0b428dbULL;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    const auto read64 = [](const unsigned char* ptr) {
+        std::uint64_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    };
+    const auto read32 = [](const unsigned char* ptr) {
+        std::uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return static_cast<std::uint64_t>(value);
+    };
+
+    seed ^= mum(seed ^ secret0, secret1);
+
+    std::uint64_t a;
+    std::uint64_t b;
+    if(len <= 16) {
+        if(len >= 4) {
+            // Je zwei überlappende 32-Bit-Wörter vom Anfang und vom Ende.
+            const auto shift = (len >> 3) << 2;
+            a = (read32(bytes) << 32) | read32(bytes + shift);
+            b = (read32(bytes + len - 4) << 32) | read32(bytes + len - 4 - shift);
+        } else if(len > 0) {
+            a = (static_cast<std::uint64_t>(bytes[0]) << 16) | (static_cast<std::uint64_t>(bytes[len >> 1]) << 8) | bytes[len - 1];
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        auto rest = len;
+        while(rest > 16) {
+            seed = mum(read64(bytes) ^ secret1, read64(bytes + 8) ^ seed);
+            bytes += 16;
+            rest -= 16;
+        }
+        // Die letzten 16 Bytes, die sich mit der vorigen Runde überlappen dürfen.
+        a = read64(bytes + rest - 16);
+        b = read64(bytes + rest - 8);
+    }
+
+    return mum(secret1 ^ len, mum(a ^ secret1, b ^ seed));
+}
+
+// Hashfunktion für die Container in cvm.
+// Ganzzahlige Schlüssel werden direkt gemischt, Zeichenketten mit hash_bytes gehasht.
+// Alle anderen Typen gehen zuerst durch std::hash, da std::hash für Ganzzahlen in libstdc++ die Identität ist und dadurch schlecht streut.
+template<class K>
+struct Hash
+{
+    [[nodiscard]] constexpr auto operator()(const K& key) const noexcept -> std::uint64_t
+    {
+        if constexpr(std::is_integral_v<K>) {
+            return mix64(static_cast<std::uint64_t>(key));
+        } else if constexpr(std::is_convertible_v<const K&, std::string_view>) {
+            const std::string_view view = key;
+            return hash_bytes(view.data(), view.size());
+        } else {
+            return mix64(static_cast<std::uint64_t>(std::hash<K>{}(key)));
+        }
+    }
+};
+
+#if defined(__AVX2__)
+namespace detail {
+
+// 64-Bit-Multiplikation in allen vier Lanes. AVX2 kennt nur 32x32->64-Bit-Produkte, daher wird
+// das untere Produkt um die beiden Kreuzprodukte ergänzt (die oberen 32x32 Bits fallen modulo 2^64 weg).
+[[nodiscard]] inline auto mullo64(__m256i x, std::uint64_t c) noexcept -> __m256i
+{
+    const auto c_lo = _mm256_set1_epi64x(static_cast<long long>(c));
+    const auto c_hi = _mm256_set1_epi64x(static_cast<long long>(c >> 32));
+    const auto lo = _mm256_mul_epu32(x, c_lo);
+    const auto cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), c_lo), _mm256_mul_epu32(x, c_hi));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+// mix64 für vier Schlüssel gleichzeitig, bitidentisch zur skalaren Version.
+[[nodiscard]] inline auto mix64x4(__m256i x) noexcept -> __m256i
+{
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mullo64(x, 0xff51afd7ed558ccdULL);
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mullo64(x, 0xc4ceb9fe1a85ec53ULL);
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    return x;
+}
+
+} // namespace detail
+#endif
+
+// Hasht einen Block von Schlüsseln in 64-Bit-Fingerabdrücke; 'out' muss mindestens so groß sein wie 'keys'.
+// Das Ergebnis ist für jeden Schlüssel identisch mit Hash<K>{}(key).
+// Mit AVX2 werden 32- und 64-Bit-Ganzzahlen in vier Lanes gleichzeitig gemischt, alle anderen Typen einzeln.
+template<class K>
+auto hash_batch(std::span<const K> keys, std::span<std::uint64_t> out) noexcept -> void
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    if constexpr(std::is_integral_v<K> && (sizeof(K) == 8 || sizeof(K) == 4)) {
+        for(; i + 4 <= keys.size(); i += 4) {
+            __m256i x;
+            if constexpr(sizeof(K) == 8) {
+                x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys.data() + i));
+            } else {
+                // 32-Bit-Schlüssel werden wie bei static_cast<std::uint64_t> vorzeichenrichtig erweitert.
+                const auto narrow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys.data() + i));
+                x = std::is_signed_v<K> ? _mm256_cvtepi32_epi64(narrow) : _mm256_cvtepu32_epi64(narrow);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i), detail::mix64x4(x));
+        }
+    }
+#endif
+
+    for(; i < keys.size(); i++) {
+        out[i] = Hash<K>{}(keys[i]);
+    }
+}
+
+} // namespace cvm
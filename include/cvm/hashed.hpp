@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/hash.hpp>
+
+namespace cvm {
+
+// Vorgeschaltete Hash-Stufe für einen Sketch über 64-Bit-Fingerabdrücke.
+// Jedes Element wird mit H auf einen 64-Bit-Wert abgebildet, bevor es den Sketch erreicht. Der Sketch vergleicht
+// und speichert dann nur noch std::uint64_t statt z.B. Zeichenketten oder zusammengesetzter Schlüssel.
+// add_batch hasht blockweise mit hash_batch (bei AVX2 vier Ganzzahlen pro Befehl).
+// Für ganzzahlige Schlüssel bis 64 Bit ist Hash eine Bijektion, sonst werden zwei Elemente mit gleichem
+// Fingerabdruck als eines gezählt (bei n verschiedenen Elementen mit Wahrscheinlichkeit etwa n^2 / 2^65).
+// Sketch kann jeder Sketch über std::uint64_t sein, z.B. KnuthSketch<std::uint64_t> oder NaiveSketch<std::uint64_t>.
+template<class T, class Sketch = KnuthSketch<std::uint64_t>, class H = Hash<T>>
+class HashedSketch
+{
+    // Rückgabetyp von Sketch::add_batch (void oder bool).
+    using BatchResult = decltype(std::declval<Sketch&>().add_batch(std::span<const std::uint64_t>{}));
+
+public:
+    // Übernimmt einen leeren (oder bereits gefüllten) Sketch über Fingerabdrücke.
+    explicit HashedSketch(Sketch sketch) noexcept
+        : sketch_(std::move(sketch))
+    {
+    }
+
+    // Verarbeitet ein Element des Streams.
+    auto add(const T& elem) noexcept
+    {
+        return sketch_.add(H{}(elem));
+    }
+
+    // Verarbeitet einen Block von Elementen in Stream-Reihenfolge.
+    // Die Fingerabdrücke werden in Blöcken fester Größe auf dem Stack berechnet und an den Sketch weitergereicht.
+    // Der Rückgabewert entspricht dem von Sketch::add_batch (z.B. false, wenn NaiveSketch gescheitert ist).
+    auto add_batch(std::span<const T> elems) noexcept -> BatchResult
+    {
+        std::array<std::uint64_t, block_size> hashes;
+        for(std::size_t offset = 0; offset < elems.size(); offset += block_size) {
+            const auto block = elems.subspan(offset, std::min(block_size, elems.size() - offset));
+            const auto out = std::span(hashes).first(block.size());
+
+            if constexpr(std::is_same_v<H, Hash<T>>) {
+                hash_batch(block, out);
+            } else {
+                std::transform(block.begin(), block.end(), out.begin(), H{});
+            }
+
+            if constexpr(std::is_void_v<BatchResult>) {
+                sketch_.add_batch(out);
+            } else if(!sketch_.add_batch(out)) {
+                return false;
+            }
+        }
+
+        if constexpr(!std::is_void_v<BatchResult>) {
+            return true;
+        }
+    }
+
+    // Vereinigt den Sketch mit 'other' (siehe merge des inneren Sketches).
+    auto merge(const HashedSketch& other) noexcept
+    {
+        return sketch_.merge(other.sketch_);
+    }
+
+    // Aktuelle Schätzung der Anzahl verschiedener Elemente.
+    [[nodiscard]] auto estimate() const noexcept
+    {
+        return sketch_.estimate();
+    }
+
+    // Zugriff auf den inneren Sketch.
+    [[nodiscard]] auto sketch() const noexcept -> const Sketch&
+    {
+        return sketch_;
+    }
+
+private:
+    // Anzahl der Fingerabdrücke, die auf einmal berechnet werden (4 KiB auf dem Stack).
+    constexpr static std::size_t block_size = 512;
+
+    Sketch sketch_; // Sketch über die Fingerabdrücke.
+};
+
+} // namespace cvm
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cvm/hash.hpp>
+#include <cvm/prefetch.hpp>
+
+namespace cvm {
+
+// Puffer für die Knuth Version des CVM-Algorithmus als Alternative zum Treap.
+// Die Elemente liegen in einem impliziten Max-Heap (Array) nach Priorität, daneben gibt es eine Hashtabelle mit
+// offener Adressierung, die jeden Schlüssel auf seine Position im Heap abbildet. Jeder Heap-Eintrag kennt umgekehrt
+// seinen Slot in der Tabelle, sodass beim Verschieben im Heap nur ein Index angepasst werden muss.
+// Suchen kostet erwartet O(1), Löschen und Ändern einer Priorität O(log n) im Array statt über Zeiger durch einen Baum.
+// Bietet dieselben Operationen wie Treap, soweit KnuthSketch sie braucht; for_each läuft aber in Heap-Reihenfolge.
+template<class K, class P>
+class IndexedHeap
+{
+public:
+    // Erzeugt einen leeren Heap.
+    IndexedHeap() noexcept
+    {
+        reserve(0);
+    }
+
+    // Erzeugt einen leeren Heap, der 'capacity' Elemente ohne weitere Allokation aufnehmen kann.
+    explicit IndexedHeap(std::size_t capacity) noexcept
+    {
+        reserve(capacity);
+    }
+
+    // Fügt ein Element mit gegebener Priorität ein. Gibt false zurück, wenn der Schlüssel bereits vorhanden ist.
+    auto insert(K elem, P prio) noexcept -> bool
+    {
+        const auto h = Hash<K>{}(elem);
+        // clang-format off
+        if(find(elem, h) != npos) return false;
+        // clang-format on
+
+        push(std::move(elem), prio, h);
+        return true;
+    }
+
+    // Entfernt ein Element. Gibt false zurück, wenn es nicht vorhanden war.
+    auto delete_elem(const K& elem) noexcept -> bool
+    {
+        const auto slot = find(elem, Hash<K>{}(elem));
+        // clang-format off
+        if(slot == npos) return false;
+        // clang-format on
+
+        erase_at(table_[slot].pos);
+        return true;
+    }
+
+    // Überprüft, ob ein Element vorhanden ist.
+    [[nodiscard]] auto contains(const K& elem) const noexcept -> bool
+    {
+        return find(elem, Hash<K>{}(elem)) != npos;
+    }
+
+    // Lädt die Tabellen-Slots und Heap-Einträge der Schlüssel 'keys' vorab in den Cache, ohne den Heap zu verändern.
+    // In der ersten Runde werden alle Start-Slots angefordert. In der zweiten sind sie meist schon da, und für jeden
+    // Slot mit passendem Hash-Anteil wird der zugehörige Heap-Eintrag angefordert, den die Suche danach vergleicht.
+    auto prefetch(std::span<const K> keys) const noexcept -> void
+    {
+        constexpr std::size_t group = 64;
+        std::array<std::uint32_t, group> tags;
+
+        for(std::size_t offset = 0; offset < keys.size(); offset += group) {
+            const auto n = std::min(group, keys.size() - offset);
+            for(std::size_t j = 0; j < n; j++) {
+                tags[j] = tag_of(Hash<K>{}(keys[offset + j]));
+                cvm::prefetch(&table_[tags[j] & mask_]);
+            }
+
+            for(std::size_t j = 0; j < n; j++) {
+                const auto& slot = table_[tags[j] & mask_];
+                if(slot.pos != empty_pos && slot.tag == tags[j]) {
+                    cvm::prefetch(&heap_[slot.pos]);
+                }
+            }
+        }
+    }
+
+    // Ein vollständiger Schritt des Knuth-CVM-Algorithmus, siehe Treap::cvm_update.
+    // Ist elem schon vorhanden, wird nur seine Priorität im Heap geändert, statt es zu löschen und neu einzufügen.
+    // Ist der Heap voll, ersetzt ein neues Element direkt die Wurzel.
+    auto cvm_update(const K& elem, P prio, P p, std::size_t s) noexcept -> P
+    {
+        const auto h = Hash<K>{}(elem);
+        const auto slot = find(elem, h);
+
+        if(prio >= p) {
+            if(slot != npos) {
+                erase_at(table_[slot].pos);
+            }
+            return p;
+        }
+
+        // Nach dem Löschen wäre wieder Platz, daher wird die Priorität nur an Ort und Stelle geändert.
+        if(slot != npos) {
+            const auto i = table_[slot].pos;
+            const auto old = heap_[i].prio;
+            heap_[i].prio = prio;
+            if(prio > old) {
+                sift_up(i);
+            } else {
+                sift_down(i);
+            }
+            return p;
+        }
+
+        if(heap_.size() < s) {
+            push(elem, prio, h);
+            return p;
+        }
+
+        // clang-format off
+        if(heap_.empty() || prio >= heap_[0].prio) return prio;
+        // clang-format on
+
+        return replace_top(elem, prio, h);
+    }
+
+    // Ein Schritt des Knuth-CVM-Algorithmus mit festen Prioritäten pro Schlüssel, siehe Treap::cvm_update_fixed.
+    // Die Hashtabelle wird erst befragt, wenn prio die Vergleiche mit p und der Wurzel übersteht.
+    auto cvm_update_fixed(const K& elem, P prio, P p, std::size_t s) noexcept -> P
+    {
+        // clang-format off
+        if(prio >= p) return p;
+        // clang-format on
+
+        const auto full = heap_.size() >= s;
+        // clang-format off
+        if(full && (heap_.empty() || prio > heap_[0].prio)) return prio;
+        // clang-format on
+
+        const auto h = Hash<K>{}(elem);
+        // clang-format off
+        if(find(elem, h) != npos) return p;
+        // clang-format on
+
+        if(!full) {
+            push(elem, prio, h);
+            return p;
+        }
+
+        return replace_top(elem, prio, h);
+    }
+
+    // Entfernt das Element mit der größten Priorität und gibt es zurück.
+    auto pop() noexcept -> std::optional<std::pair<K, P>>
+    {
+        // clang-format off
+        if(heap_.empty()) return std::nullopt;
+        // clang-format on
+
+        auto result = std::pair{heap_[0].elem, heap_[0].prio};
+        erase_at(0);
+        return result;
+    }
+
+    // Element mit der größten Priorität.
+    [[nodiscard]] auto top() const noexcept -> std::optional<std::pair<K, P>>
+    {
+        // clang-format off
+        if(heap_.empty()) return std::nullopt;
+        // clang-format on
+
+        return std::pair{heap_[0].elem, heap_[0].prio};
+    }
+
+    // Ruft 'f(elem, prio)' für jedes Element auf (in Heap-Reihenfolge).
+    template<class F>
+    auto for_each(F f) const noexcept -> void
+    {
+        for(const auto& entry : heap_) {
+            f(entry.elem, entry.prio);
+        }
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return heap_.size();
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return heap_.empty();
+    }
+
+    // Leert den Heap, der Speicher bleibt allokiert.
+    auto clear() noexcept -> void
+    {
+        heap_.clear();
+        std::fill(table_.begin(), table_.end(), Slot{});
+    }
+
+    // Ersetzt den Inhalt durch die Paare (elem, prio) aus 'items' mit verschiedenen Schlüsseln, siehe Treap::assign_sorted.
+    // Die Reihenfolge spielt hier keine Rolle: Der Heap wird in O(n) von unten nach oben aufgebaut (Floyd).
+    auto assign_sorted(std::span<const std::pair<K, P>> items) noexcept -> void
+    {
+        clear();
+        reserve(items.size());
+
+        for(const auto& [elem, prio] : items) {
+            const auto i = static_cast<std::uint32_t>(heap_.size());
+            heap_.push_back(Entry{prio, elem, 0});
+            heap_[i].slot = place(i, Hash<K>{}(elem));
+        }
+
+        for(auto i = heap_.size() / 2; i-- > 0;) {
+            sift_down(i);
+        }
+    }
+
+    // Stellt sicher, dass 'capacity' Elemente ohne weitere Allokation Platz haben (Lastfaktor der Tabelle <= 1/2).
+    auto reserve(std::size_t capacity) noexcept -> void
+    {
+        heap_.reserve(capacity);
+
+        const auto needed = std::bit_ceil(std::max<std::size_t>(2 * capacity, 8));
+        // clang-format off
+        if(needed <= table_.size()) return;
+        // clang-format on
+
+        table_.assign(needed, Slot{});
+        mask_ = needed - 1;
+        for(std::uint32_t i = 0; i < heap_.size(); i++) {
+            const auto h = Hash<K>{}(heap_[i].elem);
+            heap_[i].slot = place(i, h);
+        }
+    }
+
+private:
+    // Eintrag im Heap. 'slot' ist die Position des Schlüssels in der Hashtabelle.
+    struct Entry
+    {
+        P prio;
+        K elem;
+        std::uint32_t slot;
+    };
+
+    // Slot der Hashtabelle: Position im Heap und die oberen 32 Bits des Hashs.
+    // Aus dem Hash-Anteil ergibt sich die Startposition, und beim Suchen werden fremde Schlüssel meist schon
+    // daran erkannt, ohne den Heap-Eintrag zu laden.
+    struct Slot
+    {
+        std::uint32_t pos = empty_pos;
+        std::uint32_t tag = 0;
+    };
+
+    constexpr static std::uint32_t empty_pos = std::numeric_limits<std::uint32_t>::max();
+    constexpr static std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    [[nodiscard]] constexpr static auto tag_of(std::uint64_t h) noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(h >> 32);
+    }
+
+    // Sucht den Slot eines Schlüssels mit Hash h, npos wenn er fehlt.
+    [[nodiscard]] auto find(const K& elem, std::uint64_t h) const noexcept -> std::size_t
+    {
+        const auto tag = tag_of(h);
+        auto idx = tag & mask_;
+        while(table_[idx].pos != empty_pos) {
+            if(table_[idx].tag == tag && heap_[table_[idx].pos].elem == elem) {
+                return idx;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        return npos;
+    }
+
+    // Trägt Heap-Position 'pos' mit Hash h in die Tabelle ein und gibt den Slot zurück.
+    auto place(std::uint32_t pos, std::uint64_t h) noexcept -> std::uint32_t
+    {
+        const auto tag = tag_of(h);
+        auto idx = tag & mask_;
+        while(table_[idx].pos != empty_pos) {
+            idx = (idx + 1) & mask_;
+        }
+
+        table_[idx] = Slot{pos, tag};
+        return static_cast<std::uint32_t>(idx);
+    }
+
+    // Backward-Shift-Löschung in der Tabelle (siehe FlatSet). Verschobene Slots melden ihre neue Position dem Heap.
+    auto remove_slot(std::size_t hole) noexcept -> void
+    {
+        auto idx = (hole + 1) & mask_;
+        while(table_[idx].pos != empty_pos) {
+            const std::size_t home = table_[idx].tag & mask_;
+            if(((idx - home) & mask_) >= ((idx - hole) & mask_)) {
+                table_[hole] = table_[idx];
+                heap_[table_[hole].pos].slot = static_cast<std::uint32_t>(hole);
+                hole = idx;
+            }
+            idx = (idx + 1) & mask_;
+        }
+
+        table_[hole] = Slot{};
+    }
+
+    // Hängt ein neues Element an den Heap an und lässt es nach oben steigen.
+    auto push(K elem, P prio, std::uint64_t h) noexcept -> void
+    {
+        if(2 * (heap_.size() + 1) > table_.size()) {
+            reserve(std::max<std::size_t>(heap_.size() + 1, 2 * heap_.size()));
+        }
+
+        const auto i = static_cast<std::uint32_t>(heap_.size());
+        heap_.push_back(Entry{prio, std::move(elem), 0});
+        heap_[i].slot = place(i, h);
+        sift_up(i);
+    }
+
+    // Ersetzt die Wurzel durch ein neues Element und gibt die Priorität der alten Wurzel zurück.
+    auto replace_top(const K& elem, P prio, std::uint64_t h) noexcept -> P
+    {
+        const auto old = heap_[0].prio;
+        remove_slot(heap_[0].slot);
+        heap_[0].elem = elem;
+        heap_[0].prio = prio;
+        heap_[0].slot = place(0, h);
+        sift_down(0);
+        return old;
+    }
+
+    // Entfernt den Eintrag an Position i aus Tabelle und Heap.
+    auto erase_at(std::size_t i) noexcept -> void
+    {
+        remove_slot(heap_[i].slot);
+
+        const auto last = heap_.size() - 1;
+        if(i != last) {
+            heap_[i] = std::move(heap_[last]);
+            table_[heap_[i].slot].pos = static_cast<std::uint32_t>(i);
+        }
+        heap_.pop_back();
+
+        if(i < heap_.size()) {
+            if(i > 0 && heap_[(i - 1) / 2].prio < heap_[i].prio) {
+                sift_up(i);
+            } else {
+                sift_down(i);
+            }
+        }
+    }
+
+    // Legt 'entry' an Position 'to' ab und trägt die neue Position in der Tabelle ein.
+    auto move_to(Entry&& entry, std::size_t to) noexcept -> void
+    {
+        heap_[to] = std::move(entry);
+        table_[heap_[to].slot].pos = static_cast<std::uint32_t>(to);
+    }
+
+    // Lässt Eintrag i nach oben steigen, solange sein Elternknoten eine kleinere Priorität hat.
+    auto sift_up(std::size_t i) noexcept -> void
+    {
+        auto entry = std::move(heap_[i]);
+        while(i > 0) {
+            const auto parent = (i - 1) / 2;
+            // clang-format off
+            if(!(heap_[parent].prio < entry.prio)) break;
+            // clang-format on
+            move_to(std::move(heap_[parent]), i);
+            i = parent;
+        }
+        move_to(std::move(entry), i);
+    }
+
+    // Lässt Eintrag i nach unten sinken, solange ein Kind eine größere Priorität hat.
+    auto sift_down(std::size_t i) noexcept -> void
+    {
+        const auto n = heap_.size();
+        auto entry = std::move(heap_[i]);
+        while(true) {
+            auto child = 2 * i + 1;
+            // clang-format off
+            if(child >= n) break;
+            if(child + 1 < n && heap_[child].prio < heap_[child + 1].prio) child++;
+            if(!(entry.prio < heap_[child].prio)) break;
+            // clang-format on
+            move_to(std::move(heap_[child]), i);
+            i = child;
+        }
+        move_to(std::move(entry), i);
+    }
+
+private:
+    std::vector<Entry> heap_;  // Max-Heap nach Priorität.
+    std::vector<Slot> table_;  // Hashtabelle: Schlüssel -> Position im Heap.
+    std::size_t mask_ = 0;     // Tabellengröße - 1 (Tabellengröße ist eine Zweierpotenz).
+};
+
+} // namespace cvm
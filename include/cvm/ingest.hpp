@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cvm/concurrent.hpp>
+#include <cvm/cvm_knuth.hpp>
+
+namespace cvm {
+
+// Begrenzte, sperrfreie Warteschlange für genau einen schreibenden und einen lesenden Thread.
+// Die Positionen beider Seiten wachsen nur und liegen auf eigenen Cache-Zeilen. Jede Seite merkt sich die zuletzt
+// gelesene Position der anderen und liest die geteilte Position erst wieder, wenn die gemerkte nicht mehr ausreicht.
+// Elemente werden blockweise übertragen, sodass pro Block nur eine Release-Speicherung anfällt.
+template<class T>
+    requires std::is_trivially_copyable_v<T>
+class SpscRing
+{
+public:
+    // Erzeugt eine leere Warteschlange für mindestens 'capacity' Elemente (aufgerundet auf eine Zweierpotenz).
+    explicit SpscRing(std::size_t capacity) noexcept
+        : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+          mask_(slots_.size() - 1)
+    {
+    }
+
+    // Hängt so viele Elemente aus 'elems' an, wie Platz ist, und gibt deren Anzahl zurück (nur der Schreiber).
+    auto try_push(std::span<const T> elems) noexcept -> std::size_t
+    {
+        const auto tail = producer_.tail.load(std::memory_order_relaxed);
+        if(slots_.size() - (tail - producer_.cached_head) < elems.size()) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+        }
+        const auto n = std::min(elems.size(), slots_.size() - (tail - producer_.cached_head));
+
+        for(std::size_t i = 0; i < n; i++) {
+            slots_[(tail + i) & mask_] = elems[i];
+        }
+        producer_.tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Entnimmt bis zu out.size() Elemente in Reihenfolge und gibt deren Anzahl zurück (nur der Leser).
+    auto try_pop(std::span<T> out) noexcept -> std::size_t
+    {
+        const auto head = consumer_.head.load(std::memory_order_relaxed);
+        if(consumer_.cached_tail - head < out.size()) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+        }
+        const auto n = std::min(out.size(), consumer_.cached_tail - head);
+
+        for(std::size_t i = 0; i < n; i++) {
+            out[i] = slots_[(head + i) & mask_];
+        }
+        consumer_.head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Anzahl der Plätze.
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return slots_.size();
+    }
+
+private:
+    struct alignas(64) ProducerSide
+    {
+        std::atomic<std::size_t> tail = 0; // Position hinter dem letzten geschriebenen Element.
+        std::size_t cached_head = 0;       // Zuletzt gelesene Position des Lesers.
+    };
+
+    struct alignas(64) ConsumerSide
+    {
+        std::atomic<std::size_t> head = 0; // Position des nächsten zu lesenden Elements.
+        std::size_t cached_tail = 0;       // Zuletzt gelesene Position des Schreibers.
+    };
+
+    std::vector<T> slots_;
+    std::size_t mask_;
+    ProducerSide producer_;
+    ConsumerSide consumer_;
+};
+
+// Ein logischer Sketch, in den mehrere Threads gleichzeitig Elemente einspeisen.
+//
+// Der Sketch selbst ist nicht threadsicher, und eine Sperre um jedes Update würde alle Threads serialisieren.
+// Stattdessen hat jeder Produzent eine eigene SpscRing und sammelt Elemente zusätzlich lokal in Blöcken von
+// staging_size, bevor er sie in die Ring schiebt. Ein eigener Verbraucher-Thread leert die Rings reihum blockweise und
+// fügt die Elemente mit add_batch in den Sketch ein. Ist eine Ring voll, wartet der Produzent (Gegendruck), bis der
+// Verbraucher aufgeholt hat. Der Durchsatz ist damit durch den einen Verbraucher begrenzt, die Produzenten zahlen
+// pro Element nur eine Kopie.
+//
+// Wer warten muss, versucht es zunächst einige Runden mit yield und blockiert dann auf einem Zähler mit
+// std::atomic::wait: Der Verbraucher auf pushed_, den jeder Produzent nach dem Schreiben in seine Ring und finish()
+// nach dem Ende erhöht, ein Produzent mit voller Ring auf popped_, den der Verbraucher nach jeder Runde mit Entnahmen
+// erhöht. Der Zähler wird vor dem letzten Versuch gelesen, daher geht kein Wecken zwischen Versuch und wait verloren.
+//
+// Der Sketch sieht eine Verzahnung der Teilströme der Produzenten. Die Reihenfolge innerhalb eines Produzenten
+// bleibt erhalten. Bei Priorities::hashed hängt das Ergebnis gar nicht von der Reihenfolge ab.
+// Während des Einspeisens liefert estimate() jederzeit ohne Sperre die zuletzt veröffentlichte Schätzung
+// (siehe ConcurrentSketch). Sketch muss dafür size() und probability() anbieten, z.B. KnuthSketch.
+template<class T, class Sketch = KnuthSketch<T>>
+class MultiProducerSketch
+{
+public:
+    // Zugang eines Produzenten. Jeder Zugang darf zu einem Zeitpunkt nur von einem Thread benutzt werden.
+    class Producer
+    {
+    public:
+        // Speist ein Element ein.
+        auto push(const T& elem) noexcept -> void
+        {
+            staging_[staged_++] = elem;
+            if(staged_ == staging_.size()) {
+                flush();
+            }
+        }
+
+        // Speist einen Block von Elementen ein. Große Blöcke gehen ohne Umweg über den lokalen Puffer in die Ring.
+        auto push_batch(std::span<const T> elems) noexcept -> void
+        {
+            if(staged_ + elems.size() <= staging_.size()) {
+                std::copy(elems.begin(), elems.end(), staging_.begin() + static_cast<std::ptrdiff_t>(staged_));
+                staged_ += elems.size();
+                return;
+            }
+            flush();
+            send(elems);
+        }
+
+        // Schiebt die lokal gesammelten Elemente in die Ring.
+        auto flush() noexcept -> void
+        {
+            send(std::span<const T>(staging_).first(staged_));
+            staged_ = 0;
+        }
+
+    private:
+        friend class MultiProducerSketch;
+
+        Producer(MultiProducerSketch& owner, std::size_t ring_capacity, std::size_t staging_size) noexcept
+            : owner_(&owner),
+              ring_(ring_capacity),
+              staging_(staging_size)
+        {
+        }
+
+        // Überträgt alle Elemente, weckt nach jedem Schreiben den Verbraucher und wartet, solange die Ring voll ist.
+        auto send(std::span<const T> elems) noexcept -> void
+        {
+            std::size_t idle_rounds = 0;
+            while(!elems.empty()) {
+                const auto popped = owner_->popped_.load(std::memory_order_acquire);
+                const auto pushed = ring_.try_push(elems);
+                if(pushed > 0) {
+                    elems = elems.subspan(pushed);
+                    idle_rounds = 0;
+                    owner_->wake_consumer();
+                } else if(++idle_rounds < spin_rounds) {
+                    std::this_thread::yield();
+                } else {
+                    owner_->popped_.wait(popped, std::memory_order_acquire);
+                }
+            }
+        }
+
+        MultiProducerSketch* owner_; // Für die Zähler zum Warten und Wecken.
+        SpscRing<T> ring_;           // Zum Verbraucher.
+        std::vector<T> staging_;     // Lokal gesammelte Elemente.
+        std::size_t staged_ = 0;     // Belegte Plätze in staging_.
+    };
+
+    // Übernimmt den Sketch und startet den Verbraucher-Thread für 'producers' Produzenten.
+    // Jede Ring fasst mindestens 'ring_capacity' Elemente.
+    MultiProducerSketch(Sketch sketch, std::size_t producers, std::size_t ring_capacity = std::size_t{1} << 16)
+        : sketch_(std::move(sketch))
+    {
+        producers_.reserve(producers);
+        for(std::size_t i = 0; i < producers; i++) {
+            producers_.emplace_back(new Producer(*this, ring_capacity, std::min(staging_size, ring_capacity)));
+        }
+        consumer_ = std::jthread([this] { consume(); });
+    }
+
+    MultiProducerSketch(const MultiProducerSketch&) = delete;
+    auto operator=(const MultiProducerSketch&) -> MultiProducerSketch& = delete;
+
+    ~MultiProducerSketch()
+    {
+        finish();
+    }
+
+    // Zugang des Produzenten 'i'.
+    [[nodiscard]] auto producer(std::size_t i) noexcept -> Producer&
+    {
+        return *producers_[i];
+    }
+
+    // Zuletzt veröffentlichte Schätzung (beliebiger Thread, ohne Sperre).
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return sketch_.estimate();
+    }
+
+    // Beendet das Einspeisen: Schiebt die lokal gesammelten Elemente aller Produzenten in ihre Rings, wartet, bis der
+    // Verbraucher alles eingefügt hat, und gibt den Sketch zurück. Darf erst aufgerufen werden, wenn kein Produzent
+    // mehr schreibt (z.B. nach join aller Produzenten-Threads). Weitere Aufrufe geben nur den Sketch zurück.
+    auto finish() noexcept -> const Sketch&
+    {
+        if(consumer_.joinable()) {
+            for(auto& producer : producers_) {
+                producer->flush();
+            }
+            stop_.store(true, std::memory_order_release);
+            wake_consumer();
+            consumer_.join();
+        }
+        return sketch_.sketch();
+    }
+
+private:
+    // Größe des lokalen Puffers eines Produzenten und der Blöcke, die der Verbraucher entnimmt.
+    constexpr static std::size_t staging_size = 1024;
+
+    // Anzahl der erfolglosen Runden mit yield, bevor ein Thread auf einem Zähler blockiert.
+    constexpr static std::size_t spin_rounds = 64;
+
+    // Meldet dem Verbraucher neue Elemente oder das Ende.
+    auto wake_consumer() noexcept -> void
+    {
+        pushed_.fetch_add(1, std::memory_order_release);
+        pushed_.notify_one();
+    }
+
+    // Leert die Rings reihum, bis finish() das Ende meldet und danach alle Rings leer sind.
+    auto consume() noexcept -> void
+    {
+        std::vector<T> block(staging_size);
+        bool stopping = false;
+        std::size_t idle_rounds = 0;
+        while(true) {
+            const auto pushed = pushed_.load(std::memory_order_acquire);
+            bool any = false;
+            for(auto& producer : producers_) {
+                const auto n = producer->ring_.try_pop(block);
+                if(n > 0) {
+                    sketch_.add_batch(std::span<const T>(block).first(n));
+                    any = true;
+                }
+            }
+
+            if(any) {
+                idle_rounds = 0;
+                popped_.fetch_add(1, std::memory_order_release);
+                popped_.notify_all();
+                continue;
+            }
+
+            // Nach dem Ende wird noch einmal alles geleert, was vor dem Signal in die Rings geschrieben wurde.
+            // clang-format off
+            if(stopping) return;
+            // clang-format on
+            stopping = stop_.load(std::memory_order_acquire);
+            if(stopping) {
+                continue;
+            }
+            if(++idle_rounds < spin_rounds) {
+                std::this_thread::yield();
+            } else {
+                pushed_.wait(pushed, std::memory_order_acquire);
+            }
+        }
+    }
+
+    ConcurrentSketch<Sketch> sketch_;                   // Nur der Verbraucher schreibt.
+    std::vector<std::unique_ptr<Producer>> producers_;  // Ein Zugang pro Produzent, Adressen bleiben fest.
+    std::atomic<bool> stop_ = false;                    // Von finish() gesetzt, wenn nichts mehr nachkommt.
+    alignas(64) std::atomic<std::uint32_t> pushed_ = 0; // Erhöht nach jedem Schreiben in eine Ring und von finish().
+    alignas(64) std::atomic<std::uint32_t> popped_ = 0; // Erhöht nach jeder Runde des Verbrauchers mit Entnahmen.
+    std::jthread consumer_;                             // Fügt die Elemente aus den Rings ein.
+};
+
+} // namespace cvm
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CVM_HAS_MMAP 1
+#else
+#define CVM_HAS_MMAP 0
+#endif
+
+namespace cvm {
+
+// Datei aus Datensätzen fester Breite (z.B. std::uint32_t oder std::uint64_t in nativer Byte-Reihenfolge),
+// die per mmap nur lesend eingeblendet wird. Die Datensätze werden ohne Kopie als zusammenhängender
+// Random-Access-Bereich angeboten und lassen sich direkt an knuth_cvm, naive_cvm oder die parallelen Varianten übergeben.
+// Der Kernel lädt die Seiten erst beim Zugriff, die Datei muss also nicht in den Arbeitsspeicher passen.
+// Bytes am Ende, die keinen ganzen Datensatz mehr ergeben, werden ignoriert.
+// Ohne <sys/mman.h> (z.B. Windows) liefert open immer std::nullopt.
+template<class T>
+    requires std::is_trivially_copyable_v<T>
+class MappedRecords
+{
+public:
+    // Blendet die Datei 'path' ein. Gibt std::nullopt zurück, wenn sie nicht geöffnet oder eingeblendet werden kann.
+    // Der Kernel bekommt den Hinweis, dass sequentiell gelesen wird (größeres Read-Ahead), und wo verfügbar,
+    // dass große Seiten verwendet werden dürfen.
+    [[nodiscard]] static auto open(const std::filesystem::path& path) noexcept -> std::optional<MappedRecords>
+    {
+#if CVM_HAS_MMAP
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        // clang-format off
+        if(fd < 0) return std::nullopt;
+        // clang-format on
+
+        struct stat st{};
+        if(::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return std::nullopt;
+        }
+
+        MappedRecords result;
+        result.bytes_ = static_cast<std::size_t>(st.st_size);
+
+        // Eine leere Datei lässt sich nicht einblenden und ergibt einen leeren Bereich.
+        if(result.bytes_ > 0) {
+            auto* addr = ::mmap(nullptr, result.bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(addr == MAP_FAILED) {
+                ::close(fd);
+                return std::nullopt;
+            }
+            result.addr_ = addr;
+
+            // Reine Hinweise, Fehler werden ignoriert.
+            ::madvise(addr, result.bytes_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            ::madvise(addr, result.bytes_, MADV_HUGEPAGE);
+#endif
+        }
+
+        // Die Einblendung bleibt nach dem Schließen des Deskriptors bestehen.
+        ::close(fd);
+        return result;
+#else
+        static_cast<void>(path);
+        return std::nullopt;
+#endif
+    }
+
+    MappedRecords(const MappedRecords&) = delete;
+    auto operator=(const MappedRecords&) -> MappedRecords& = delete;
+
+    MappedRecords(MappedRecords&& other) noexcept
+        : addr_(std::exchange(other.addr_, nullptr)),
+          bytes_(std::exchange(other.bytes_, 0))
+    {
+    }
+
+    auto operator=(MappedRecords&& other) noexcept -> MappedRecords&
+    {
+        if(this != &other) {
+            unmap();
+            addr_ = std::exchange(other.addr_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedRecords() noexcept
+    {
+        unmap();
+    }
+
+    // Zeiger auf den ersten Datensatz (nullptr bei leerer Datei).
+    [[nodiscard]] auto data() const noexcept -> const T*
+    {
+        return static_cast<const T*>(addr_);
+    }
+
+    // Anzahl der ganzen Datensätze in der Datei.
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return bytes_ / sizeof(T);
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> const T*
+    {
+        return data();
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const T*
+    {
+        return data() + size();
+    }
+
+    [[nodiscard]] auto operator[](std::size_t i) const noexcept -> const T&
+    {
+        return data()[i];
+    }
+
+    // Alle Datensätze als Span, z.B. für KnuthSketch::add_batch.
+    [[nodiscard]] auto records() const noexcept -> std::span<const T>
+    {
+        return {data(), size()};
+    }
+
+private:
+    MappedRecords() noexcept = default;
+
+    auto unmap() noexcept -> void
+    {
+#if CVM_HAS_MMAP
+        if(addr_ != nullptr) {
+            ::munmap(addr_, bytes_);
+        }
+#endif
+        addr_ = nullptr;
+        bytes_ = 0;
+    }
+
+    void* addr_ = nullptr;  // Anfang der Einblendung.
+    std::size_t bytes_ = 0; // Größe der Datei in Bytes.
+};
+
+} // namespace cvm
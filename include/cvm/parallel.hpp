@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/cvm_naive.hpp>
+#include <cvm/hash.hpp>
+#include <cvm/random.hpp>
+
+namespace cvm {
+
+// Anzahl der Threads, wenn der Aufrufer 0 übergibt.
+[[nodiscard]] inline auto default_threads() noexcept -> std::size_t
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Ordnet einem Schlüssel eine von 'parts' Partitionen zu.
+// Verwendet die oberen Bits des Hashs (Multiply-Shift), da die unteren Bits bereits die Slots der Hashtabellen bestimmen.
+template<class T>
+[[nodiscard]] inline auto partition_of(const T& elem, std::size_t parts) noexcept -> std::size_t
+{
+    return static_cast<std::size_t>((static_cast<unsigned __int128>(Hash<T>{}(elem)) * parts) >> 64);
+}
+
+// Verteilt einen Random-Access-Bereich auf sketches.size() Threads und lässt Thread t die Elemente in sketches[t] einfügen.
+//
+// Da die Prioritäten zufällig pro Vorkommen gezogen werden, lassen sich Sketches nur über disjunkte Schlüsselmengen
+// exakt vereinigen (siehe KnuthSketch::merge). Daher wird nicht der Bereich selbst in Stücke geteilt, sondern die Schlüssel:
+//  1. Jeder Thread verteilt sein zusammenhängendes Stück des Bereichs nach Hash auf sketches.size() Partitionen.
+//  2. Thread t fügt Partition t aus allen Stücken in Stück-Reihenfolge in seinen Sketch ein.
+// Jeder Sketch sieht damit genau die Teilfolge des Streams mit seinen Schlüsseln, in der ursprünglichen Reihenfolge.
+// Ohne Sketches (leerer Bereich 'sketches') passiert nichts.
+// Wird die Funktion für mehrere Bereiche nacheinander mit denselben Sketches aufgerufen, gilt das für den ganzen Stream.
+template<std::random_access_iterator Iter, class Sketch>
+static auto parallel_add_batch(Iter begin, Iter end, std::span<Sketch> sketches) noexcept -> void
+{
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    const auto threads = sketches.size();
+    // clang-format off
+    if(threads == 0) return;
+    // clang-format on
+    const auto n = static_cast<std::size_t>(std::distance(begin, end));
+    const auto chunk = (n + threads - 1) / threads;
+
+    // parts[i][t]: Elemente aus Stück i, die zu Partition t gehören.
+    std::vector<std::vector<std::vector<ItemType>>> parts(threads);
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for(std::size_t i = 0; i < threads; i++) {
+            workers.emplace_back([&, i] {
+                auto& local = parts[i];
+                local.resize(threads);
+
+                const auto first = std::min(n, i * chunk);
+                const auto last = std::min(n, first + chunk);
+                for(auto& part : local) {
+                    part.reserve((last - first) / threads + 16);
+                }
+
+                for(auto it = begin + first; it != begin + last; ++it) {
+                    local[partition_of(*it, threads)].push_back(*it);
+                }
+            });
+        }
+    }
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for(std::size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                for(std::size_t i = 0; i < threads; i++) {
+                    // Der Rückgabewert (z.B. bei NaiveSketch) bleibt im Sketch selbst erhalten.
+                    static_cast<void>(sketches[t].add_batch(std::span<const ItemType>(parts[i][t])));
+                    parts[i][t] = {}; // Speicher sofort freigeben.
+                }
+            });
+        }
+    }
+}
+
+// Wie parallel_add_batch, aber die 'threads' Sketches werden mit 'make_sketch(t)' erzeugt und in Thread-Reihenfolge
+// zurückgegeben.
+template<std::random_access_iterator Iter, class MakeSketch>
+[[nodiscard]] static auto parallel_sketches(Iter begin, Iter end, std::size_t threads, MakeSketch make_sketch) noexcept
+{
+    using SketchType = decltype(make_sketch(std::size_t{0}));
+
+    std::vector<SketchType> sketches;
+    sketches.reserve(threads);
+    for(std::size_t t = 0; t < threads; t++) {
+        sketches.push_back(make_sketch(t));
+    }
+
+    parallel_add_batch(begin, end, std::span<SketchType>(sketches));
+    return sketches;
+}
+
+// Parallele Knuth Version des CVM-Algorithmus über einen Random-Access-Bereich mit 'threads' Threads (0 = alle Kerne).
+// Jeder Thread hat einen eigenen Puffer und einen eigenen Generator, dessen Seed aus 'seed' abgeleitet wird.
+// Mit festem Seed und fester Thread-Anzahl ist das Ergebnis reproduzierbar.
+// Mode wählt, woher die Prioritäten kommen (siehe Priorities).
+template<template<class, class> class Buffer = SlabTreap, Priorities Mode = Priorities::random, std::random_access_iterator Iter>
+[[nodiscard]] static auto parallel_knuth_cvm(Iter begin, Iter end, std::size_t s, std::size_t threads = 0,
+                                             std::uint64_t seed = random_seed()) noexcept -> std::optional<double>
+{
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    // clang-format off
+    if(threads == 0) threads = default_threads();
+    // clang-format on
+
+    const auto n = static_cast<std::size_t>(std::distance(begin, end));
+    auto sketches = parallel_sketches(begin, end, threads, [&](std::size_t /*t*/) {
+        KnuthSketch<ItemType, Buffer, Mode> sketch(s, WyRand{splitmix64(seed)});
+        sketch.reserve(n / threads + 1);
+        return sketch;
+    });
+
+    for(std::size_t t = 1; t < threads; t++) {
+        sketches[0].merge(sketches[t]);
+    }
+
+    return sketches[0].estimate();
+}
+
+// Parallele naive Version des CVM-Algorithmus über einen Random-Access-Bereich mit 'threads' Threads (0 = alle Kerne).
+// Der Schwellenwert wird für alle Sketches aus der Länge des ganzen Bereichs berechnet.
+template<Sampling Mode = Sampling::geometric, std::random_access_iterator Iter>
+[[nodiscard]] static auto parallel_naive_cvm(Iter begin, Iter end, double EPSILON, double DELTA, std::size_t threads = 0,
+                                             std::uint64_t seed = random_seed()) noexcept -> std::optional<double>
+{
+    using ItemType = typename std::iterator_traits<Iter>::value_type;
+
+    // clang-format off
+    if(threads == 0) threads = default_threads();
+    // clang-format on
+
+    const auto n = static_cast<std::size_t>(std::distance(begin, end));
+    auto sketches = parallel_sketches(begin, end, threads, [&](std::size_t /*t*/) {
+        return NaiveSketch<ItemType, Mode>(EPSILON, DELTA, n, WyRand{splitmix64(seed)});
+    });
+
+    for(std::size_t t = 1; t < threads; t++) {
+        if(!sketches[0].merge(sketches[t])) {
+            return std::nullopt;
+        }
+    }
+
+    return sketches[0].estimate();
+}
+
+} // namespace cvm
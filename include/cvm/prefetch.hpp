@@ -0,0 +1,14 @@
+#pragma once
+
+namespace cvm {
+
+// Lädt die Cache-Line an 'addr' vorab zum Lesen in alle Cache-Ebenen. Ist nur ein Hinweis an den Prozessor,
+// ungültige Adressen sind erlaubt und lösen keinen Fehler aus. Ohne GCC/Clang-Builtin passiert nichts.
+inline auto prefetch([[maybe_unused]] const void* addr) noexcept -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 0, 3);
+#endif
+}
+
+} // namespace cvm
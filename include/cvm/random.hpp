@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+namespace cvm {
+
+// SplitMix64: Leitet aus einem Zustand eine Folge gut gemischter 64-Bit-Werte ab.
+// Wird zum Aufbereiten von Seeds verwendet, damit auch kleine oder ähnliche Seeds unabhängige Folgen liefern.
+[[nodiscard]] constexpr auto splitmix64(std::uint64_t& state) noexcept -> std::uint64_t
+{
+    auto z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// wyrand: Ein sehr schneller Zufallszahlengenerator mit nur 8 Byte Zustand.
+// Erfüllt std::uniform_random_bit_generator und kann daher auch mit den Verteilungen der Standardbibliothek verwendet werden.
+class WyRand
+{
+public:
+    using result_type = std::uint64_t;
+
+    // Erzeugt einen Generator aus einem Seed. Gleicher Seed ergibt die gleiche Folge.
+    constexpr explicit WyRand(std::uint64_t seed = 0) noexcept
+        : state_(splitmix64(seed))
+    {
+    }
+
+    constexpr auto operator()() noexcept -> result_type
+    {
+        state_ += 0xa0761d6478bd642fULL;
+        const auto product = static_cast<unsigned __int128>(state_) * (state_ ^ 0xe7037ed1a0b428dbULL);
+        return static_cast<result_type>(product >> 64) ^ static_cast<result_type>(product);
+    }
+
+    [[nodiscard]] constexpr static auto min() noexcept -> result_type
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    [[nodiscard]] constexpr static auto max() noexcept -> result_type
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// Liefert einen nicht reproduzierbaren Seed aus std::random_device.
+[[nodiscard]] inline auto random_seed() noexcept -> std::uint64_t
+{
+    std::random_device rd{};
+    return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+// Generator pro Thread für Aufrufe ohne expliziten Generator.
+// Wird einmalig pro Thread aus std::random_device initialisiert und ist daher threadsicher, aber nicht reproduzierbar.
+[[nodiscard]] inline auto default_rng() noexcept -> WyRand&
+{
+    thread_local WyRand rng{random_seed()};
+    return rng;
+}
+
+// Wandelt 64 Zufallsbits in ein gleichverteiltes Double aus [0, 1) um.
+// Die oberen 53 Bits werden direkt als Mantisse verwendet, ohne Umweg über eine Verteilung.
+[[nodiscard]] constexpr auto to_unit_double(std::uint64_t bits) noexcept -> double
+{
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// Zieht ein gleichverteiltes Double aus [0, 1) aus einem beliebigen Generator.
+template<std::uniform_random_bit_generator Rng>
+[[nodiscard]] inline auto uniform01(Rng& rng) noexcept -> double
+{
+    if constexpr(Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint64_t>::max()) {
+        return to_unit_double(rng());
+    } else {
+        return std::generate_canonical<double, std::numeric_limits<double>::digits>(rng);
+    }
+}
+
+// Liefert faire Münzwürfe und verbraucht dafür nur einen Aufruf des Generators pro 64 Würfe.
+// Generatoren, die keine vollen 64 Bits liefern, werden pro Wurf einmal aufgerufen.
+class CoinFlips
+{
+public:
+    template<std::uniform_random_bit_generator Rng>
+    [[nodiscard]] auto operator()(Rng& rng) noexcept -> bool
+    {
+        if constexpr(Rng::min() != 0 || Rng::max() != std::numeric_limits<std::uint64_t>::max()) {
+            return uniform01(rng) < 0.5;
+        }
+
+        if(remaining_ == 0) {
+            bits_ = rng();
+            remaining_ = 64;
+        }
+
+        const auto coin = (bits_ & 1) != 0;
+        bits_ >>= 1;
+        remaining_--;
+        return coin;
+    }
+
+private:
+    std::uint64_t bits_ = 0; // Noch nicht verbrauchte Zufallsbits.
+    int remaining_ = 0;      // Anzahl der noch nicht verbrauchten Bits.
+};
+
+// Erzeugt eine Folge unabhängiger Bernoulli-Versuche mit Wahrscheinlichkeit p, zieht aber nicht pro Versuch eine
+// Zufallszahl. Stattdessen wird die Anzahl der Fehlschläge bis zum nächsten Erfolg geometrisch gezogen und heruntergezählt.
+// Bei kleinem p braucht das etwa p * n statt n Aufrufe des Generators für n Versuche.
+class GeometricSampler
+{
+public:
+    // Erzeugt einen Sampler mit Wahrscheinlichkeit 1 (jeder Versuch ist ein Erfolg).
+    GeometricSampler() noexcept = default;
+
+    // Setzt eine neue Erfolgswahrscheinlichkeit. Die laufende Lücke wird verworfen und neu gezogen;
+    // da die Versuche gedächtnislos sind, bleibt die Verteilung der folgenden Versuche dabei exakt erhalten.
+    template<std::uniform_random_bit_generator Rng>
+    auto set_probability(double p, Rng& rng) noexcept -> void
+    {
+        p_ = p;
+        if(p_ < 1.0 && p_ > 0.0) {
+            log_q_ = std::log1p(-p_);
+        }
+        skip_ = draw_gap(rng);
+    }
+
+    // Führt einen Versuch aus und gibt true bei Erfolg zurück.
+    template<std::uniform_random_bit_generator Rng>
+    [[nodiscard]] auto operator()(Rng& rng) noexcept -> bool
+    {
+        if(skip_ > 0) {
+            skip_--;
+            return false;
+        }
+
+        skip_ = draw_gap(rng);
+        return true;
+    }
+
+private:
+    // Anzahl der Fehlschläge vor dem nächsten Erfolg: floor(log(U) / log(1 - p)) mit U aus (0, 1].
+    template<std::uniform_random_bit_generator Rng>
+    [[nodiscard]] auto draw_gap(Rng& rng) const noexcept -> std::uint64_t
+    {
+        // clang-format off
+        if(p_ >= 1.0) return 0;
+        if(p_ <= 0.0) return std::numeric_limits<std::uint64_t>::max();
+        // clang-format on
+
+        const auto gap = std::floor(std::log(1.0 - uniform01(rng)) / log_q_);
+        // clang-format off
+        if(gap >= 0x1.0p63) return std::numeric_limits<std::uint64_t>::max();
+        // clang-format on
+
+        return static_cast<std::uint64_t>(gap);
+    }
+
+private:
+    double p_ = 1.0;         // Erfolgswahrscheinlichkeit eines Versuchs.
+    double log_q_ = 0.0;     // log(1 - p), vorberechnet für die Lückenlänge.
+    std::uint64_t skip_ = 0; // Anzahl der Fehlschläge bis zum nächsten Erfolg.
+};
+
+} // namespace cvm
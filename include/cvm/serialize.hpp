@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace cvm {
+
+// Bausteine des binären Formats, in dem KnuthSketch::serialize einen Sketch ablegt:
+//
+//   Offset  Bytes  Inhalt
+//   0       4      Magic "CVMK"
+//   4       1      Version (serial::version)
+//   5       1      Breite des Schlüsseltyps in Bytes
+//   6       1      Herkunft der Prioritäten (0 = random, 1 = hashed)
+//   7       1      1, wenn der Schlüsseltyp vorzeichenbehaftet ist, sonst 0
+//   8       8      Puffergröße s
+//   16      8      Schwelle p (Bits des double)
+//   24      8      Anzahl n der Elemente
+//   32      8      Seed des Hashs (nur hashed, sonst 0)
+//   40      ...    n Schlüssel in aufsteigender Reihenfolge, jeweils die Differenz zum Vorgänger als Varint
+//   ...     4 n    nur random: Prioritäten in derselben Reihenfolge, quantisiert auf 32 Bit relativ zu p
+//
+// Alle Zahlen sind Little-Endian. Bei hashed werden keine Prioritäten gespeichert, da sie sich aus Schlüssel und
+// Seed exakt neu berechnen lassen.
+namespace serial {
+
+constexpr std::array<std::byte, 4> magic = {std::byte{'C'}, std::byte{'V'}, std::byte{'M'}, std::byte{'K'}};
+constexpr std::uint8_t version = 1;
+constexpr std::size_t header_size = 40;
+
+// Bildet einen ganzzahligen Schlüssel ordnungserhaltend auf std::uint64_t ab (bei signed wird das Vorzeichenbit gekippt).
+template<std::integral T>
+[[nodiscard]] constexpr auto to_ordered(T key) noexcept -> std::uint64_t
+{
+    using U = std::make_unsigned_t<T>;
+    auto u = static_cast<U>(key);
+    if constexpr(std::is_signed_v<T>) {
+        u ^= U{1} << (8 * sizeof(T) - 1);
+    }
+    return u;
+}
+
+// Umkehrung von to_ordered.
+template<std::integral T>
+[[nodiscard]] constexpr auto from_ordered(std::uint64_t u) noexcept -> T
+{
+    using U = std::make_unsigned_t<T>;
+    auto key = static_cast<U>(u);
+    if constexpr(std::is_signed_v<T>) {
+        key ^= U{1} << (8 * sizeof(T) - 1);
+    }
+    return static_cast<T>(key);
+}
+
+// Quantisiert eine Priorität in [0, p) auf 32 Bit. Die Reihenfolge der Prioritäten bleibt erhalten (bis auf Gleichstände).
+[[nodiscard]] inline auto quantize(double prio, double p) noexcept -> std::uint32_t
+{
+    const auto scaled = std::floor(prio / p * 0x1p32);
+    return static_cast<std::uint32_t>(std::clamp(scaled, 0.0, 0x1p32 - 1));
+}
+
+// Mitte des Intervalls, das 'q' darstellt. Liegt immer echt unter p.
+[[nodiscard]] inline auto dequantize(std::uint32_t q, double p) noexcept -> double
+{
+    return (static_cast<double>(q) + 0.5) * 0x1p-32 * p;
+}
+
+// Hängt Zahlen in Little-Endian bzw. als Varint an einen Byte-Puffer an.
+class Writer
+{
+public:
+    explicit Writer(std::vector<std::byte>& out) noexcept
+        : out_(out)
+    {
+    }
+
+    auto bytes(std::span<const std::byte> data) -> void
+    {
+        out_.insert(out_.end(), data.begin(), data.end());
+    }
+
+    template<std::unsigned_integral U>
+    auto fixed(U value) -> void
+    {
+        for(std::size_t i = 0; i < sizeof(U); i++) {
+            out_.push_back(static_cast<std::byte>(value >> (8 * i)));
+        }
+    }
+
+    // LEB128: 7 Bit pro Byte, das oberste Bit zeigt an, dass ein weiteres Byte folgt.
+    auto varint(std::uint64_t value) -> void
+    {
+        while(value >= 0x80) {
+            out_.push_back(static_cast<std::byte>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<std::byte>(value));
+    }
+
+private:
+    std::vector<std::byte>& out_;
+};
+
+// Liest Zahlen aus einem Byte-Puffer. Jede Methode gibt std::nullopt zurück, wenn der Puffer zu Ende oder
+// die Kodierung ungültig ist.
+class Reader
+{
+public:
+    explicit Reader(std::span<const std::byte> in) noexcept
+        : in_(in)
+    {
+    }
+
+    [[nodiscard]] auto bytes(std::size_t n) noexcept -> std::optional<std::span<const std::byte>>
+    {
+        // clang-format off
+        if(in_.size() - pos_ < n) return std::nullopt;
+        // clang-format on
+        const auto result = in_.subspan(pos_, n);
+        pos_ += n;
+        return result;
+    }
+
+    template<std::unsigned_integral U>
+    [[nodiscard]] auto fixed() noexcept -> std::optional<U>
+    {
+        const auto data = bytes(sizeof(U));
+        // clang-format off
+        if(!data) return std::nullopt;
+        // clang-format on
+
+        U value = 0;
+        for(std::size_t i = 0; i < sizeof(U); i++) {
+            value |= static_cast<U>(static_cast<U>((*data)[i]) << (8 * i));
+        }
+        return value;
+    }
+
+    [[nodiscard]] auto varint() noexcept -> std::optional<std::uint64_t>
+    {
+        std::uint64_t value = 0;
+        for(unsigned shift = 0; shift < 64; shift += 7) {
+            // clang-format off
+            if(pos_ == in_.size()) return std::nullopt;
+            // clang-format on
+            const auto byte = static_cast<std::uint64_t>(in_[pos_++]);
+            value |= (byte & 0x7f) << shift;
+            // clang-format off
+            if(byte < 0x80) return value;
+            // clang-format on
+        }
+        return std::nullopt;
+    }
+
+    // Anzahl der noch nicht gelesenen Bytes.
+    [[nodiscard]] auto remaining() const noexcept -> std::size_t
+    {
+        return in_.size() - pos_;
+    }
+
+private:
+    std::span<const std::byte> in_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace serial
+
+} // namespace cvm
@@ -1,23 +1,110 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <optional>
 #include <random>
+#include <span>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cvm/arena.hpp>
+#include <cvm/prefetch.hpp>
+#include <cvm/random.hpp>
 
 namespace cvm {
 
 // Implementierung eines Treap mit Schlüsseln vom Typ K und Prioritäten vom Typ P.
 // Standardmäßig ist der Typ für Prioritäten ein Double.
-template<class K, class P = double>
+// Allocator legt fest, woher die Knoten kommen und wie sie verlinkt sind. Standardmäßig liegen sie in einer
+// SlabArena und sind über Zeiger verbunden, mit HeapAllocator wird jeder Knoten einzeln mit new/delete angelegt.
+// Mit IndexArena liegen alle Knoten in einem Array und die Kinder werden über 32-Bit-Indizes referenziert.
+// Mit SubtreeSizes = true speichert jeder Knoten die Größe seines Subbaums, was Ordnungsstatistiken (nth) erlaubt.
+// Ansonsten wird nur ein einzelner Zähler für den ganzen Treap geführt.
+template<class K, class P = double, template<class> class Allocator = SlabArena, bool SubtreeSizes = false>
 class Treap
 {
+    struct Node;
+
+    // Typ der Verweise auf Knoten (Zeiger oder Index), vorgegeben durch den Allokator.
+    using Link = typename Allocator<Node>::link;
+
+    // Verweis, der auf keinen Knoten zeigt.
+    constexpr static Link null = Allocator<Node>::null;
+
 public:
+    // Schlüssel und Priorität eines Elements, wie sie beim Iterieren geliefert werden.
+    // Die Priorität steht vorne, damit bei kleinen Schlüsseln (z.B. 32 Bit) kein Padding im Knoten entsteht.
+    struct Entry
+    {
+        P prio; // Priorität des Elements.
+        K elem; // Schlüssel des Elements.
+    };
+
+    class const_iterator;
+
     // Standardkonstruktor, der einen leeren Treap erstellt.
     constexpr Treap() noexcept
-        : root_(nullptr) // Wurzelknoten wird auf nullptr gesetzt.
+        : root_(null) // Wurzelknoten wird auf null gesetzt.
+    {
+    }
+
+    // Erstellt einen leeren Treap, dessen Allokator bereits Platz für 'capacity' Knoten hat.
+    // Solange der Treap nicht mehr Elemente enthält, finden keine weiteren Heap-Allokationen statt.
+    explicit Treap(std::size_t capacity) noexcept
+        : alloc_(capacity),
+          root_(null)
+    {
+    }
+
+    // Erstellt einen Treap aus Paaren (elem, prio) mit streng aufsteigenden Schlüsseln in O(n), siehe assign_sorted.
+    explicit Treap(std::span<const std::pair<K, P>> sorted) noexcept
+        : alloc_(sorted.size()),
+          root_(null)
+    {
+        assign_sorted(sorted);
+    }
+
+    // Kopierkonstruktor, der eine tiefe Kopie aller Knoten mit derselben Form anlegt.
+    Treap(const Treap& other) noexcept
+        : alloc_(other.size()),
+          root_(copy(other)),
+          size_(other.size_)
+    {
+    }
+
+    // Movekonstruktor, der die Knoten samt Allokator übernimmt.
+    Treap(Treap&& other) noexcept
+        : alloc_(std::move(other.alloc_)),
+          root_(std::exchange(other.root_, null)),
+          size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    auto operator=(const Treap& other) noexcept -> Treap&
+    {
+        if(this != &other) {
+            auto tmp = other;
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    auto operator=(Treap&& other) noexcept -> Treap&
     {
+        if(this != &other) {
+            auto tmp = std::move(other);
+            swap(tmp);
+        }
+        return *this;
     }
 
     // Destruktor, der den Treap und all seine Knoten zerstört.
@@ -26,123 +113,312 @@ public:
         destroy(root_);
     }
 
+    // Tauscht den Inhalt zweier Treaps.
+    auto swap(Treap& other) noexcept -> void
+    {
+        std::swap(alloc_, other.alloc_);
+        std::swap(root_, other.root_);
+        std::swap(size_, other.size_);
+    }
+
     // Einfügemethode, die ein Element in den Treap einfügt,
     // wobei die Priorität zufällig generiert wird.
-    auto insert(const K& elem) noexcept -> void
+    auto insert(const K& elem) noexcept -> bool
     {
         const auto prio = generate_prio();
-        insert(elem, prio);
+        return insert(elem, prio);
+    }
+
+    // Wie insert(elem), aber die Priorität wird aus dem übergebenen Generator gezogen.
+    template<std::uniform_random_bit_generator Rng>
+    auto insert(const K& elem, Rng& rng) noexcept -> bool
+    {
+        const auto prio = generate_prio(rng);
+        return insert(elem, prio);
     }
 
     // Einfügemethode, die ein Element mit einer gegebenen Priorität in den Treap einfügt.
-    auto insert(K elem, P prio) noexcept -> void
+    // Gibt false zurück, wenn der Schlüssel bereits vorhanden ist; der Treap bleibt dann unverändert.
+    //
+    // Das Einfügen läuft iterativ von oben nach unten: Zuerst wird die Stelle gesucht, an der der neue Knoten
+    // wegen seiner Priorität hingehört. Der dort hängende Subbaum wird dann entlang des Suchpfads in die Teile
+    // kleiner und größer als elem zerlegt, die zum linken und rechten Kind des neuen Knotens werden.
+    auto insert(K elem, P prio) noexcept -> bool
     {
-        // Diese Hilfslambda führt das rekursive Einfügen durch.
-        constexpr static auto insert_recursive =
-            [&](auto& self, auto* node, K&& elem, P prio) -> Node* {
-            if(!node) {
-                return new Node{elem, prio};
+        // Abstieg bis zum ersten Knoten mit kleinerer Priorität. Eltern und Richtung werden gemerkt,
+        // da create() bei IndexArena Knoten verschieben kann und Zeiger auf Verweise dann ungültig würden.
+        auto parent = null;
+        auto go_right = false;
+        auto node = root_;
+        while(node != null && at(node).prio >= prio) {
+            // clang-format off
+            if(at(node).elem == elem) return false;
+            // clang-format on
+
+            parent = node;
+            go_right = at(node).elem < elem;
+            node = go_right ? at(node).right : at(node).left;
+        }
+
+        // Der Schlüssel kann auch noch unterhalb der Einfügestelle liegen.
+        // Dabei wird gleich die Anzahl der kleineren Schlüssel im Subbaum gezählt.
+        SizeType less = 0;
+        for(auto x = node; x != null;) {
+            // clang-format off
+            if(at(x).elem == elem) return false;
+            // clang-format on
+
+            if(at(x).elem < elem) {
+                less += 1 + subtree_size(at(x).left);
+                x = at(x).right;
+            } else {
+                x = at(x).left;
             }
+        }
 
-            if(elem < node->elem) {
-                node->left = self(self, node->left, std::move(elem), prio);
-                if(node->left->prio > node->prio) {
-                    node = rotate_right(node);
-                }
-            } else if(elem > node->elem) {
-                node->right = self(self, node->right, std::move(elem), prio);
-                if(node->right->prio > node->prio) {
-                    node = rotate_left(node);
-                }
+        const auto fresh = alloc_.create(prio, std::move(elem));
+        auto& inserted = at(fresh);
+
+        // Alle Knoten oberhalb der Einfügestelle bekommen ein Element mehr in ihrem Subbaum.
+        if constexpr(SubtreeSizes) {
+            for(auto x = root_; x != node;) {
+                at(x).size++;
+                x = at(x).elem < inserted.elem ? at(x).right : at(x).left;
             }
+            inserted.size = subtree_size(node) + 1;
+        }
 
-            update_size(node);
+        // Zerlegt den Subbaum an der Einfügestelle in die beiden Kinder des neuen Knotens.
+        split(node, inserted.elem, inserted.left, inserted.right, less, subtree_size(node) - less);
 
-            return node;
-        };
+        child_slot(parent, go_right) = fresh;
+        size_++;
 
-        root_ = insert_recursive(insert_recursive, root_, std::move(elem), prio);
+        return true;
     }
 
-    // Überprüft, ob ein Element mit Schlüssel K im Treap vorhanden ist.
-    [[nodiscard]] auto contains(const K& elem) const noexcept -> bool
+    // Ein vollständiger Schritt des Knuth-CVM-Algorithmus in einem einzigen Abstieg.
+    // Entspricht delete_elem(elem), gefolgt von: Ist prio < p, wird elem mit prio eingefügt, solange der Treap
+    // weniger als s Elemente enthält. Sonst wird es nur eingefügt, wenn prio kleiner als die Priorität der Wurzel ist,
+    // die dann entfernt wird. Gibt den neuen Wert von p zurück.
+    //
+    // Beim Abstieg wird sowohl der Knoten mit elem als auch die Stelle gesucht, an die prio gehört.
+    // Ist elem schon vorhanden, wird sein Knoten wiederverwendet und nur umgehängt, statt gelöscht und neu angelegt.
+    auto cvm_update(const K& elem, P prio, P p, std::size_t s) noexcept -> P
     {
-        // Hilfslambda für die rekursive Suche.
-        constexpr static auto contains_recursive =
-            [&](auto& self, const auto* const node, const K& queryElem) -> bool {
+        // Mit Subbaum-Größen werden die einzelnen Operationen verwendet, die die Größen pflegen.
+        if constexpr(SubtreeSizes) {
+            delete_elem(elem);
             // clang-format off
-            if(!node) return false;
+            if(prio >= p) return p;
             // clang-format on
 
-            if(node->elem == queryElem) {
-                return true;
+            if(size() < s) {
+                insert(elem, prio);
+                return p;
+            }
+
+            // clang-format off
+            if(root_ == null || prio >= at(root_).prio) return prio;
+            // clang-format on
+
+            const auto popped = pop();
+            insert(elem, prio);
+            return popped->second;
+        } else {
+            // Die neue Priorität ist zu groß, das Element wird nur entfernt.
+            if(prio >= p) {
+                delete_elem(elem);
+                return p;
+            }
+
+            // Abstieg entlang des Suchpfads von elem. Gemerkt werden der Knoten mit elem (falls vorhanden) und der
+            // erste Knoten mit kleinerer Priorität, also die Stelle, an der ein Knoten mit prio hängen muss.
+            auto parent = null;
+            auto go_right = false;
+            auto node = root_;
+            auto ins = null;
+            auto ins_parent = null;
+            auto ins_right = false;
+            auto have_ins = false;
+            while(node != null) {
+                const auto& x = at(node);
+                if(!have_ins && x.prio < prio) {
+                    have_ins = true;
+                    ins = node;
+                    ins_parent = parent;
+                    ins_right = go_right;
+                }
+
+                // clang-format off
+                if(x.elem == elem) break;
+                // clang-format on
+
+                parent = node;
+                go_right = x.elem < elem;
+                node = go_right ? x.right : x.left;
+            }
+
+            // Ohne Knoten mit kleinerer Priorität gehört der neue Knoten an das Ende des Suchpfads.
+            if(!have_ins) {
+                ins = node;
+                ins_parent = parent;
+                ins_right = go_right;
+            }
+
+            if(node != null) {
+                // elem ist schon vorhanden: Nach dem Löschen ist Platz, es wird also immer wieder eingefügt.
+                auto& x = at(node);
+                if(!have_ins) {
+                    // Die neue Priorität ist nicht größer als die alte, der Knoten sinkt nach unten.
+                    sift_down(child_slot(parent, go_right), node, prio);
+                } else if(ins == node) {
+                    // Die neue Priorität passt genau an die bisherige Stelle.
+                    x.prio = prio;
+                } else {
+                    // Der Knoten steigt bis zur Einfügestelle auf. Der Subbaum dort wird an elem zerlegt,
+                    // wobei der alte Knoten herausgelöst wird und seine Kinder auf beide Seiten verteilt.
+                    Link left = null;
+                    Link right = null;
+                    split(ins, elem, left, right);
+                    x.prio = prio;
+                    x.left = left;
+                    x.right = right;
+                    child_slot(ins_parent, ins_right) = node;
+                }
+                return p;
             }
 
-            if(queryElem < node->elem) {
-                return self(self, node->left, queryElem);
+            // elem ist neu. Ist der Treap voll, muss prio kleiner als die Priorität der Wurzel sein.
+            const auto full = size_ >= s;
+            if(full && (root_ == null || prio >= at(root_).prio)) {
+                return prio;
             }
 
-            return self(self, node->right, queryElem);
-        };
+            // Erst einfügen, dann die Wurzel entfernen, damit die gefundene Einfügestelle gültig bleibt.
+            // Da prio kleiner als die Priorität der Wurzel ist, liegt die Einfügestelle immer unterhalb der Wurzel.
+            const auto fresh = alloc_.create(prio, elem);
+            split(ins, elem, at(fresh).left, at(fresh).right);
+            child_slot(ins_parent, ins_right) = fresh;
+            size_++;
 
-        return contains_recursive(contains_recursive, root_, elem);
+            if(full) {
+                return pop()->second;
+            }
+
+            return p;
+        }
     }
 
-    // Methode zum Löschen eines Elements mit dem gegebenen Schlüssel K aus dem Treap.
-    auto delete_elem(const K& elem) noexcept
+    // Ein Schritt des Knuth-CVM-Algorithmus, wenn jeder Schlüssel bei jedem Vorkommen dieselbe Priorität hat
+    // (z.B. aus einem Hash des Schlüssels). Ein vorhandenes Element müsste dann mit derselben Priorität wieder
+    // eingefügt werden, daher entfällt das Löschen und es bleibt ein Einfügen, falls elem noch fehlt.
+    // Elemente mit prio >= p oder, bei vollem Treap, mit prio über der Priorität der Wurzel werden mit einem
+    // einzigen Vergleich abgewiesen, ohne den Baum zu betreten. Gibt den neuen Wert von p zurück.
+    auto cvm_update_fixed(const K& elem, P prio, P p, std::size_t s) noexcept -> P
     {
-        // Eine Hilfs-Lambda-Funktion für die rekursive Löschung.
-        constexpr static auto delete_recursive =
-            [&](auto& self, auto* node, const K& elem) -> Node* {
-            // Base case: Knoten nicht gefunden, gib null zurück.
+        // clang-format off
+        if(prio >= p) return p;
+        // clang-format on
+
+        // Bei vollem Treap kann elem nur enthalten sein, wenn es die Wurzel ist oder prio kleiner als deren Priorität.
+        // Sonst wird wie in cvm_update p = prio, auch wenn ein anderer Schlüssel dieselbe Priorität hat.
+        if(size_ >= s) {
             // clang-format off
-            if(!node) return nullptr;
+            if(root_ == null) return prio;
+            if(at(root_).elem == elem) return p;
+            if(!(prio < at(root_).prio)) return prio;
             // clang-format on
+        }
 
-            // Wenn der zu löschende Knoten gefunden wird.
-            if(elem == node->elem) {
-
-                // Wenn der Knoten beide Kinder hat, entscheide die Rotation basierend auf der Priorität.
-                if(node->left && node->right) {
-                    if(node->left->prio > node->right->prio) {
-                        // Rotation nach rechts
-                        node = rotate_right(node);
-                        node->right = self(self, node->right, elem);
-                    } else {
-                        // Rotation nach links
-                        node = rotate_left(node);
-                        node->left = self(self, node->left, elem);
-                    }
-                } else {
-                    // Knoten mit nur einem Kind oder keinem Kind.
-                    Node* temp;
-                    if(!node->left) {
-                        temp = node->right;
-                        delete node;
-                        return temp;
-                    }
+        // clang-format off
+        if(!insert(elem, prio)) return p;
+        // clang-format on
+
+        // War der Treap voll, wird die Wurzel mit der größten Priorität verdrängt.
+        if(size_ > s) {
+            return pop()->second;
+        }
+
+        return p;
+    }
+
+    // Überprüft, ob ein Element mit Schlüssel K im Treap vorhanden ist.
+    [[nodiscard]] auto contains(const K& elem) const noexcept -> bool
+    {
+        auto node = root_;
+        while(node != null) {
+            if(at(node).elem == elem) {
+                return true;
+            }
+            node = elem < at(node).elem ? at(node).left : at(node).right;
+        }
 
-                    if(!node->right) {
-                        temp = node->left;
-                        delete node;
-                        return temp;
+        return false;
+    }
+
+    // Lädt die Suchpfade der Schlüssel 'keys' vorab in den Cache, ohne den Treap zu verändern.
+    // Die Pfade werden gruppenweise im Gleichschritt abgestiegen: Pro Runde geht jeder Pfad eine Ebene tiefer und
+    // stößt das Laden seines nächsten Knotens an. Bis derselbe Pfad in der nächsten Runde wieder an der Reihe ist,
+    // sind die anderen Ladevorgänge der Gruppe gleichzeitig unterwegs, statt wie bei einer einzelnen Suche nacheinander.
+    // Sinnvoll, wenn der Treap nicht mehr in den Cache passt und die Schlüssel kurz danach gesucht oder eingefügt werden.
+    auto prefetch(std::span<const K> keys) const noexcept -> void
+    {
+        constexpr std::size_t group = 64;
+        std::array<Link, group> path;
+
+        for(std::size_t offset = 0; offset < keys.size(); offset += group) {
+            const auto n = std::min(group, keys.size() - offset);
+            path.fill(root_);
+
+            for(auto active = root_ != null; active;) {
+                active = false;
+                for(std::size_t j = 0; j < n; j++) {
+                    // clang-format off
+                    if(path[j] == null) continue;
+                    // clang-format on
+
+                    const auto& key = keys[offset + j];
+                    const auto& node = at(path[j]);
+                    path[j] = node.elem == key ? null : key < node.elem ? node.left : node.right;
+                    if(path[j] != null) {
+                        cvm::prefetch(&at(path[j]));
+                        active = true;
                     }
                 }
-            } else if(elem < node->elem) {
-                // Wenn das zu löschende Element kleiner als das aktuelle Knotenelement ist.
-                node->left = self(self, node->left, elem);
-            } else {
-                // Wenn das zu löschende Element größer als das aktuelle Knotenelement ist.
-                node->right = self(self, node->right, elem);
             }
+        }
+    }
 
-            // Größe aktualisieren.
-            update_size(node);
+    // Methode zum Löschen eines Elements mit dem gegebenen Schlüssel K aus dem Treap.
+    // Der Knoten wird gesucht und an seiner Stelle werden seine beiden Subbäume mit join() verbunden.
+    // Gibt false zurück, wenn der Schlüssel nicht vorhanden war.
+    auto delete_elem(const K& elem) noexcept -> bool
+    {
+        auto* slot = &root_;
+        while(*slot != null && !(at(*slot).elem == elem)) {
+            slot = elem < at(*slot).elem ? &at(*slot).left : &at(*slot).right;
+        }
 
-            return node;
-        };
+        // clang-format off
+        if(*slot == null) return false;
+        // clang-format on
 
-        root_ = delete_recursive(delete_recursive, root_, elem);
+        const auto node = *slot;
+
+        // Erst jetzt ist klar, dass gelöscht wird, also verlieren alle Vorfahren ein Element.
+        if constexpr(SubtreeSizes) {
+            for(auto x = root_; x != node;) {
+                at(x).size--;
+                x = elem < at(x).elem ? at(x).left : at(x).right;
+            }
+        }
+
+        *slot = join(at(node).left, at(node).right);
+        alloc_.destroy(node);
+        size_--;
+
+        return true;
     }
 
     // pop wird implementiert, indem der Root entfernt wird und dann der linke und rechte Teilbaum des Root Knotens zusammengeführt werden mit join()
@@ -150,19 +426,20 @@ public:
     {
         // Überprüfe, ob der Wurzelknoten leer ist
         // clang-format off
-        if(!root_) return std::nullopt;
+        if(root_ == null) return std::nullopt;
         // clang-format on
 
         // Hole den Wert des Wurzelknotens
-        auto root_value = std::move(root_->elem);
-        auto prio = root_->prio;
+        auto root_value = std::move(at(root_).elem);
+        auto prio = at(root_).prio;
 
-        // Speichere Zeiger auf linke und rechte Kinder
-        auto* const leftChild = root_->left;
-        auto* const rightChild = root_->right;
+        // Speichere Verweise auf linke und rechte Kinder
+        const auto leftChild = at(root_).left;
+        const auto rightChild = at(root_).right;
 
         // Lösche den Wurzelknoten
-        delete root_;
+        alloc_.destroy(root_);
+        size_--;
 
         // Erstelle einen neuen Treap aus dem linken und rechten Unterbaum
         root_ = join(leftChild, rightChild);
@@ -174,18 +451,72 @@ public:
     {
         // Überprüfe, ob der Wurzelknoten leer ist
         // clang-format off
-        if(!root_) return std::nullopt;
+        if(root_ == null) return std::nullopt;
         // clang-format on
 
-        return std::pair{root_->elem, root_->prio};
+        return std::pair{at(root_).elem, at(root_).prio};
+    }
+
+    // Gibt das Element mit dem i-kleinsten Schlüssel zurück (beginnend bei 0).
+    // Nur verfügbar, wenn die Knoten die Größen ihrer Subbäume speichern.
+    [[nodiscard]] auto nth(std::size_t i) const noexcept -> std::optional<std::pair<K, P>>
+        requires SubtreeSizes
+    {
+        auto node = root_;
+        while(node != null) {
+            const std::size_t left = subtree_size(at(node).left);
+            if(i == left) {
+                return std::pair{at(node).elem, at(node).prio};
+            }
+
+            if(i < left) {
+                node = at(node).left;
+            } else {
+                i -= left + 1;
+                node = at(node).right;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Ruft 'f(elem, prio)' für jedes Element in aufsteigender Reihenfolge der Schlüssel auf.
+    // Der Pfad von der Wurzel wird auf einem Stack gehalten, daher ist die Tiefe des Baums nicht durch den Call-Stack begrenzt.
+    template<class F>
+    auto for_each(F f) const noexcept -> void
+    {
+        std::vector<Link> path;
+        auto node = root_;
+        while(node != null || !path.empty()) {
+            while(node != null) {
+                path.push_back(node);
+                node = at(node).left;
+            }
+
+            node = path.back();
+            path.pop_back();
+            f(at(node).elem, at(node).prio);
+            node = at(node).right;
+        }
+    }
+
+    // Iterator auf das Element mit dem kleinsten Schlüssel. Die Elemente werden in aufsteigender Reihenfolge der
+    // Schlüssel besucht, wie bei for_each.
+    [[nodiscard]] auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator(this, root_);
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const_iterator
+    {
+        return const_iterator();
     }
 
     [[nodiscard]] constexpr auto size() const noexcept -> std::size_t
     {
-        // Gibt die Größe des Treaps zurück.
-        // Wenn der Wurzelknoten (root_) existiert, gibt die Größe dieses Knotens zurück.
-        // Andernfalls, wenn der Wurzelknoten nicht existiert, gibt 0 zurück.
-        return root_ ? root_->size : 0;
+        // Gibt die Anzahl der Elemente im Treap zurück.
+        // Der Zähler wird bei jedem Einfügen und Löschen angepasst, unabhängig von SubtreeSizes.
+        return size_;
     }
 
     [[nodiscard]] constexpr auto empty() const noexcept -> bool
@@ -193,135 +524,536 @@ public:
         // Überprüft, ob der Treap leer ist.
         // Gibt 'true' zurück, wenn der Wurzelknoten nicht existiert (d.h. der Treap ist leer).
         // Andernfalls gibt 'false' zurück.
-        return not static_cast<bool>(root_);
+        return root_ == null;
     }
 
     constexpr auto clear() noexcept -> void
     {
-        // Löscht alle Knoten des Treaps und setzt den Wurzelknoten auf nullptr.
-        // Die Methode 'destroy' wird aufgerufen, um alle Knoten rekursiv zu löschen.
+        // Löscht alle Knoten des Treaps und setzt den Wurzelknoten auf null.
         destroy(root_);
-        root_ = nullptr;
+        root_ = null;
+        size_ = 0;
     }
 
-    [[nodiscard]] static auto generate_prio() noexcept -> P
+    // Stellt sicher, dass der Allokator Platz für insgesamt 'capacity' Knoten hat.
+    auto reserve(std::size_t capacity) noexcept -> void
     {
-        // Generiert eine Priorität für einen Treap-Knoten.
-        // 'rd' ist ein Zufallsgenerator, der zur Initialisierung von 'gen' (Mersenne Twister) verwendet wird.
-        static std::random_device rd{};
+        alloc_.reserve(capacity);
+    }
 
-        // 'gen' ist ein Mersenne-Twister-Zufallsgenerator.
-        static std::mt19937 gen = std::mt19937{rd()};
+    // Ersetzt den Inhalt durch die Paare (elem, prio) aus 'items', deren Schlüssel streng aufsteigend sortiert sein müssen.
+    // Der Treap wird in O(n) als kartesischer Baum aufgebaut, ohne einzelne Einfügungen: Der rechte Rand des bisherigen
+    // Baums liegt auf einem Stack. Ein neues Element hängt rechts unten an, und alle Knoten des Randes mit kleinerer
+    // Priorität werden zu seinem linken Subbaum. Jeder Knoten wird höchstens einmal vom Stack genommen.
+    auto assign_sorted(std::span<const std::pair<K, P>> items) noexcept -> void
+    {
+        clear();
+        alloc_.reserve(items.size());
 
-        // Abhängig davon, ob der Typ P ein Gleitkomma-Typ ist,
-        // wird entweder eine Gleichverteilung für Gleitkommazahlen oder Ganzzahlen erstellt.
-        static std::conditional_t<std::is_floating_point_v<P>,
-                                  std::uniform_real_distribution<>,
-                                  std::uniform_int_distribution<>>
-            dist{};
+        std::vector<Link> spine;
+        for(const auto& [elem, prio] : items) {
+            const auto node = alloc_.create(prio, elem);
 
-        // Gibt einen zufälligen Wert aus der gewählten Verteilung zurück.
-        return dist(gen);
+            auto last = null;
+            while(!spine.empty() && at(spine.back()).prio < prio) {
+                last = spine.back();
+                spine.pop_back();
+                update_size(last);
+            }
+
+            at(node).left = last;
+            if(!spine.empty()) {
+                at(spine.back()).right = node;
+            }
+            spine.push_back(node);
+        }
+
+        // Der verbliebene rechte Rand ist fertig, die Größen werden von unten nach oben gesetzt.
+        for(auto it = spine.rbegin(); it != spine.rend(); ++it) {
+            update_size(*it);
+        }
+
+        root_ = spine.empty() ? null : spine.front();
+        size_ = items.size();
     }
 
-private:
-    // Struktur, die einen Knoten im Treap repräsentiert.
-    struct Node
-    {
-        K elem;                // Schlüsselwert des Knotens.
-        P prio;                // Priorität des Knotens.
-        Node* left = nullptr;  // Zeiger auf den linken Kindknoten.
-        Node* right = nullptr; // Zeiger auf den rechten Kindknoten.
-        std::size_t size = 1;  // Größe des Subbaums, der an diesem Knoten hängt.
-    };
+    // Vereinigung: Fügt alle Elemente von 'other' hinzu. Bei gleichen Schlüsseln gilt die Priorität aus 'other'.
+    // Mengenoperationen zerlegen diesen Treap rekursiv mit split entlang der Schlüssel von 'other' und setzen die Teile
+    // mit join wieder zusammen. Das kostet O(m log(n/m + 1)) für m = other.size() <= n, statt m einzelner Einfügungen.
+    // Da jeder Treap seinen eigenen Allokator hat, werden die Knoten von 'other' vorher in O(m) hierher kopiert.
+    // Mit threads > 1 werden bei großen Treaps die obersten Rekursionsebenen parallel bearbeitet (Fork-Join).
+    auto unite(const Treap& other, std::size_t threads = 1) noexcept -> void
+    {
+        alloc_.reserve(size_ + other.size_);
+        const auto clone = copy(other);
+        const auto found = set_operation<SetOp::unite>(*this, clone, threads, other.size_);
+        size_ += other.size_ - found;
+    }
 
-    // Aktualisiert die Größe eines gegebenen Knotens basierend auf der Größe seiner Kinder.
-    constexpr static auto update_size(Node* x) noexcept
+    // Schnittmenge: Behält nur die Elemente, deren Schlüssel auch in 'other' vorkommen, mit ihren eigenen Prioritäten.
+    // Laufzeit und Parallelisierung wie bei unite, 'other' wird aber nur gelesen und nicht kopiert.
+    auto intersect(const Treap& other, std::size_t threads = 1) noexcept -> void
     {
-        x->size = 1 + (x->left ? x->left->size : 0) + (x->right ? x->right->size : 0);
+        size_ = set_operation<SetOp::intersect>(other, other.root_, threads, other.size_);
     }
 
-    // Führt eine Linksdrehung für einen gegebenen Knoten durch.
-    constexpr static auto rotate_left(Node* x) noexcept -> Node*
+    // Differenz: Entfernt alle Elemente, deren Schlüssel in 'other' vorkommen. Laufzeit wie bei intersect.
+    auto subtract(const Treap& other, std::size_t threads = 1) noexcept -> void
     {
-        auto* const y = x->right;
-        x->right = y->left;
-        y->left = x;
+        size_ -= set_operation<SetOp::subtract>(other, other.root_, threads, other.size_);
+    }
 
-        // Aktualisiert die Größen der Knoten nach der Rotation.
-        update_size(x);
-        update_size(y);
+    // Generiert eine Priorität für einen Treap-Knoten aus dem Generator des aufrufenden Threads.
+    [[nodiscard]] static auto generate_prio() noexcept -> P
+    {
+        return generate_prio(default_rng());
+    }
 
-        return y; // Gibt den neuen Wurzelknoten nach der Drehung zurück
+    // Generiert eine Priorität für einen Treap-Knoten aus dem übergebenen Generator.
+    // Gleitkomma-Prioritäten sind gleichverteilt in [0, 1), ganzzahlige gleichverteilt über alle nicht-negativen Werte von P.
+    template<std::uniform_random_bit_generator Rng>
+    [[nodiscard]] static auto generate_prio(Rng& rng) noexcept -> P
+    {
+        if constexpr(std::is_floating_point_v<P>) {
+            return static_cast<P>(uniform01(rng));
+        } else {
+            return static_cast<P>(std::uniform_int_distribution<std::uint64_t>(0, std::numeric_limits<P>::max())(rng));
+        }
     }
 
-    // Führt eine Rechtsdrehung für einen gegebenen Knoten durch.
-    constexpr static auto rotate_right(Node* y) noexcept -> Node*
+private:
+    // Größe der Subbäume. Bei Index-Verweisen genügen 32 Bit, da ohnehin höchstens 2^32 Knoten adressierbar sind.
+    using SizeType = std::conditional_t<std::is_pointer_v<Link>, std::size_t, std::uint32_t>;
+
+    // Platzhalter, wenn keine Subbaum-Größen gespeichert werden. Belegt dank [[no_unique_address]] keinen Platz.
+    struct NoSize
     {
-        auto* const x = y->left;
-        y->left = x->right;
-        x->right = y;
+    };
 
-        // Aktualisiert die Größen der Knoten nach der Rotation.
-        update_size(x);
-        update_size(y);
+    using SizeField = std::conditional_t<SubtreeSizes, SizeType, NoSize>;
 
-        return x; // Gibt den neuen Wurzelknoten nach der Drehung zurück.
+    // Anfangswert der Subbaum-Größe eines neuen Knotens.
+    [[nodiscard]] constexpr static auto initial_size() noexcept -> SizeField
+    {
+        if constexpr(SubtreeSizes) {
+            return 1;
+        } else {
+            return {};
+        }
     }
 
-    // Verbindet zwei Subbäume (left und right) in einen einzigen Baum, wobei die Prioritäten beachtet werden.
-    constexpr static auto join(Node* left, Node* right) noexcept -> Node*
+    // Struktur, die einen Knoten im Treap repräsentiert: Schlüssel und Priorität aus Entry und die Verweise auf die Kinder.
+    struct Node : Entry
+    {
+        Link left = null;                                  // Verweis auf den linken Kindknoten.
+        Link right = null;                                 // Verweis auf den rechten Kindknoten.
+        [[no_unique_address]] SizeField size = initial_size(); // Größe des Subbaums, nur mit SubtreeSizes.
+    };
+
+    // Zugriff auf den Knoten hinter einem Verweis.
+    [[nodiscard]] constexpr auto at(Link x) noexcept -> Node&
+    {
+        return alloc_[x];
+    }
+
+    [[nodiscard]] constexpr auto at(Link x) const noexcept -> const Node&
+    {
+        return alloc_[x];
+    }
+
+    // Verweis im Elternknoten (oder die Wurzel, wenn es keinen Elternknoten gibt), an dem ein Kind hängt.
+    [[nodiscard]] constexpr auto child_slot(Link parent, bool right) noexcept -> Link&
     {
         // clang-format off
-        if(!left)  return right; // Wenn der linke Subbaum null ist, gibt den rechten Subbaum zurück.
-        if(!right) return left; // Wenn der rechte Subbaum null ist, gibt den linken Subbaum zurück.
+        if(parent == null) return root_;
         // clang-format on
 
-        Node* result;
+        return right ? at(parent).right : at(parent).left;
+    }
+
+    // Größe eines Subbaums. Ohne SubtreeSizes wird der Wert nie gebraucht und ist immer 0.
+    [[nodiscard]] constexpr auto subtree_size([[maybe_unused]] Link x) const noexcept -> SizeType
+    {
+        if constexpr(SubtreeSizes) {
+            return x != null ? at(x).size : 0;
+        } else {
+            return 0;
+        }
+    }
+
+    // Setzt die Subbaum-Größe von x aus den Größen seiner Kinder, die bereits stimmen müssen.
+    constexpr auto update_size([[maybe_unused]] Link x) noexcept -> void
+    {
+        if constexpr(SubtreeSizes) {
+            at(x).size = 1 + subtree_size(at(x).left) + subtree_size(at(x).right);
+        }
+    }
+
+    // Zerlegt den Subbaum 'node' in die Schlüssel kleiner und größer als 'key' und hängt sie an 'left' und 'right'.
+    // Ein Knoten mit genau dem Schlüssel 'key' wird herausgelöst und zurückgegeben, ansonsten null.
+    // Mit SubtreeSizes geben left_size und right_size an, wie viele Schlüssel kleiner bzw. größer als 'key' sind.
+    // Daraus ergeben sich die neuen Größen der Knoten auf beiden Rändern von oben nach unten.
+    constexpr auto split(Link node, const K& key, Link& left, Link& right,
+                         [[maybe_unused]] SizeType left_size = 0,
+                         [[maybe_unused]] SizeType right_size = 0) noexcept -> Link
+    {
+        auto* left_slot = &left;
+        auto* right_slot = &right;
+        while(node != null) {
+            auto& x = at(node);
+            if(x.elem < key) {
+                if constexpr(SubtreeSizes) {
+                    x.size = left_size;
+                    left_size -= 1 + subtree_size(x.left);
+                }
+                *left_slot = node;
+                left_slot = &x.right;
+                node = x.right;
+            } else if(key < x.elem) {
+                if constexpr(SubtreeSizes) {
+                    x.size = right_size;
+                    right_size -= 1 + subtree_size(x.right);
+                }
+                *right_slot = node;
+                right_slot = &x.left;
+                node = x.left;
+            } else {
+                // Alle Schlüssel links vom gefundenen Knoten sind kleiner, alle rechts davon größer.
+                *left_slot = x.left;
+                *right_slot = x.right;
+                return node;
+            }
+        }
+
+        *left_slot = null;
+        *right_slot = null;
+        return null;
+    }
+
+    // Senkt die Priorität des Knotens 'node', der an 'slot' hängt, auf 'prio' und lässt ihn per Rotation
+    // nach unten wandern, bis beide Kinder keine größere Priorität mehr haben.
+    constexpr auto sift_down(Link& slot, Link node, P prio) noexcept -> void
+    {
+        at(node).prio = prio;
+
+        auto* current = &slot;
+        while(true) {
+            const auto left = at(node).left;
+            const auto right = at(node).right;
+
+            // Wähle das Kind mit der größten Priorität, sofern sie größer als prio ist.
+            auto child = null;
+            if(left != null && at(left).prio > prio) {
+                child = left;
+            }
+            if(right != null && at(right).prio > prio && (child == null || at(right).prio > at(left).prio)) {
+                child = right;
+            }
+
+            // clang-format off
+            if(child == null) return;
+            // clang-format on
+
+            *current = child;
+            if(child == left) {
+                // Rotation nach rechts
+                at(node).left = at(left).right;
+                at(left).right = node;
+                current = &at(left).right;
+            } else {
+                // Rotation nach links
+                at(node).right = at(right).left;
+                at(right).left = node;
+                current = &at(right).left;
+            }
+        }
+    }
+
+    // Wie split, aber mit SubtreeSizes werden die Anzahlen der kleineren und größeren Schlüssel vorher gezählt.
+    constexpr auto split_counted(Link node, const K& key, Link& left, Link& right) noexcept -> Link
+    {
+        if constexpr(SubtreeSizes) {
+            SizeType less = 0;
+            auto found = false;
+            for(auto x = node; x != null && !found;) {
+                if(at(x).elem < key) {
+                    less += 1 + subtree_size(at(x).left);
+                    x = at(x).right;
+                } else if(key < at(x).elem) {
+                    x = at(x).left;
+                } else {
+                    less += subtree_size(at(x).left);
+                    found = true;
+                }
+            }
+            return split(node, key, left, right, less, subtree_size(node) - less - (found ? 1 : 0));
+        } else {
+            return split(node, key, left, right);
+        }
+    }
+
+    enum class SetOp { unite, intersect, subtract };
+
+    // Zustand eines Zweigs der Mengenoperation: Knoten, die erst nach dem Ende gelöscht werden
+    // (der Allokator ist nicht threadsicher), und die Anzahl der Schlüssel, die in beiden Treaps vorkamen.
+    struct SetTask
+    {
+        std::vector<Link> garbage;
+        std::size_t found = 0;
+    };
+
+    // Führt eine Mengenoperation zwischen diesem Treap und dem Baum ab 'b' in 'src' aus und gibt die Anzahl
+    // der gemeinsamen Schlüssel zurück. Bei unite ist src dieser Treap selbst und b die Kopie von 'other'.
+    template<SetOp Op>
+    auto set_operation(const Treap& src, Link b, std::size_t threads, std::size_t other_size) noexcept -> std::size_t
+    {
+        // Erst ab dieser Gesamtgröße lohnt es sich, Threads zu starten.
+        constexpr std::size_t parallel_min_size = std::size_t{1} << 16;
+        const auto depth = threads > 1 && size_ + other_size >= parallel_min_size ? std::bit_width(threads - 1) : 0;
+
+        SetTask task;
+        root_ = set_operation<Op>(root_, src, b, static_cast<int>(depth), task);
+        for(const auto node : task.garbage) {
+            destroy(node);
+        }
+        return task.found;
+    }
+
+    // Rekursion der Mengenoperation: 'a' wird am Schlüssel der Wurzel von 'b' zerlegt, die Hälften werden mit den
+    // Kindern von 'b' verrechnet und mit join wieder verbunden. 'b' wird nur gelesen, außer bei unite, wo die
+    // Knoten von 'b' (in diesem Treap) direkt in das Ergebnis wandern. Auf den obersten 'depth' Ebenen läuft die
+    // linke Hälfte in einem eigenen Thread. Dabei werden keine Knoten angelegt oder gelöscht.
+    template<SetOp Op>
+    auto set_operation(Link a, const Treap& src, Link b, int depth, SetTask& task) noexcept -> Link
+    {
+        if(b == null) {
+            if constexpr(Op == SetOp::intersect) {
+                // clang-format off
+                if(a != null) task.garbage.push_back(a);
+                // clang-format on
+                return null;
+            } else {
+                return a;
+            }
+        }
+        if(a == null) {
+            return Op == SetOp::unite ? b : null;
+        }
+
+        const auto& pivot = src.at(b);
+        const auto b_left = pivot.left;
+        const auto b_right = pivot.right;
+
+        Link left = null;
+        Link right = null;
+        auto match = split_counted(a, pivot.elem, left, right);
+        if(match != null) {
+            at(match).left = null;
+            at(match).right = null;
+            update_size(match);
+            task.found++;
+        }
 
-        // Entscheidet, welcher Subbaum an der Wurzel basierend auf den Prioritäten bleibt.
-        if(left->prio > right->prio) {
-            left->right = join(left->right, right);
-            result = left;
+        Link result_left = null;
+        Link result_right = null;
+        if(depth > 0) {
+            SetTask left_task;
+            {
+                std::jthread worker(
+                    [&] { result_left = set_operation<Op>(left, src, b_left, depth - 1, left_task); });
+                result_right = set_operation<Op>(right, src, b_right, depth - 1, task);
+            }
+            task.garbage.insert(task.garbage.end(), left_task.garbage.begin(), left_task.garbage.end());
+            task.found += left_task.found;
         } else {
-            right->left = join(left, right->left);
-            result = right;
+            result_left = set_operation<Op>(left, src, b_left, 0, task);
+            result_right = set_operation<Op>(right, src, b_right, 0, task);
+        }
+
+        // Der mittlere Knoten: bei unite der aus 'b' (dessen Priorität gewinnt), bei intersect der eigene.
+        Link middle = null;
+        if constexpr(Op == SetOp::unite) {
+            middle = b;
+            at(b).left = null;
+            at(b).right = null;
+            update_size(b);
+            // clang-format off
+            if(match != null) task.garbage.push_back(match);
+            // clang-format on
+        } else if constexpr(Op == SetOp::intersect) {
+            middle = match;
+        } else if(match != null) {
+            task.garbage.push_back(match);
+        }
+
+        return join(join(result_left, middle), result_right);
+    }
+
+    // Verbindet zwei Subbäume (left und right) in einen einzigen Baum, wobei die Prioritäten beachtet werden.
+    // Alle Schlüssel in left müssen kleiner als die in right sein.
+    // Iterativ von oben nach unten: Der rechte Rand von left wird mit dem linken Rand von right verzahnt.
+    constexpr auto join(Link left, Link right) noexcept -> Link
+    {
+        Link result = null;
+        auto* slot = &result;
+
+        // Entscheidet in jedem Schritt, welcher Subbaum an dieser Stelle basierend auf den Prioritäten bleibt.
+        while(left != null && right != null) {
+            if(at(left).prio > at(right).prio) {
+                if constexpr(SubtreeSizes) {
+                    at(left).size += at(right).size;
+                }
+                *slot = left;
+                slot = &at(left).right;
+                left = at(left).right;
+            } else {
+                if constexpr(SubtreeSizes) {
+                    at(right).size += at(left).size;
+                }
+                *slot = right;
+                slot = &at(right).left;
+                right = at(right).left;
+            }
         }
 
-        // Aktualisiert die Größe des resultierenden Baums.
-        update_size(result);
+        // Der übrige Subbaum wird unverändert angehängt.
+        *slot = left != null ? left : right;
 
         return result;
     }
 
-    // Rekursiv zerstört (löscht) einen Baum ab einem gegebenen Knoten.
-    constexpr static auto destroy(Node* node) noexcept -> void
+    // Zerstört (löscht) einen Baum ab einem gegebenen Knoten ohne Rekursion.
+    // Linke Kinder werden per Rechtsrotation nach oben geholt, bis der aktuelle Knoten keines mehr hat.
+    constexpr auto destroy(Link node) noexcept -> void
     {
-        if(node) {
-            destroy(node->left);
-            destroy(node->right);
-            delete node; // Löscht den aktuellen Knoten.
+        while(node != null) {
+            const auto left = at(node).left;
+            if(left != null) {
+                at(node).left = at(left).right;
+                at(left).right = node;
+                node = left;
+            } else {
+                const auto right = at(node).right;
+                alloc_.destroy(node); // Löscht den aktuellen Knoten.
+                node = right;
+            }
         }
     }
 
-    // Hilfsfunktion, um eine tiefe Kopie des Baumes zu erstellen.
-    constexpr static auto copy(Node* node) noexcept -> Node*
+    // Legt eine tiefe Kopie des Baumes von 'other' an und gibt die neue Wurzel zurück.
+    // Die Knoten werden in Preorder ohne Rekursion kopiert: Auf dem Stack liegt zu jedem noch offenen Quellknoten
+    // der bereits angelegte Zielknoten, dessen Kinder noch fehlen.
+    constexpr auto copy(const Treap& other) noexcept -> Link
     {
         // clang-format off
-        if(!node) return nullptr; // Wenn der gegebene Knoten null ist, gibt null zurück.
+        if(other.root_ == null) return null;
         // clang-format on
 
-        Node* newNode = new Node;
-        newNode->elem = node->elem;         // Kopiert den Schlüsselwert.
-        newNode->prio = node->prio;         // Kopiert die Priorität.
-        newNode->left = copy(node->left);   // Rekursiv kopiert den linken Subbaum.
-        newNode->right = copy(node->right); // Rekursiv kopiert den rechten Subbaum.
-        newNode->size = node->size;         // Kopiert die Größe.
-        return newNode;
+        const auto root = alloc_.create(other.at(other.root_));
+        std::vector<std::pair<Link, Link>> pending{{other.root_, root}};
+        while(!pending.empty()) {
+            const auto [src, dst] = pending.back();
+            pending.pop_back();
+
+            // create() kann bei IndexArena Knoten verschieben, daher wird 'dst' erst danach wieder aufgelöst.
+            for(const auto right : {false, true}) {
+                const auto child = right ? other.at(src).right : other.at(src).left;
+                auto copied = null;
+                if(child != null) {
+                    copied = alloc_.create(other.at(child));
+                    pending.emplace_back(child, copied);
+                }
+                (right ? at(dst).right : at(dst).left) = copied;
+            }
+        }
+
+        return root;
     }
 
 private:
-    Node* root_; // Zeiger auf den Wurzelknoten des Treaps.
+    Allocator<Node> alloc_; // Allokator, aus dem alle Knoten dieses Treaps stammen.
+    Link root_;             // Verweis auf den Wurzelknoten des Treaps.
+    std::size_t size_ = 0;  // Anzahl der Elemente im Treap.
 };
 
+// Iterator über die Elemente eines Treaps in aufsteigender Reihenfolge der Schlüssel.
+// Da die Knoten keine Verweise auf ihre Eltern haben, hält der Iterator den Pfad von der Wurzel zum aktuellen Knoten
+// (nur die Knoten, deren rechter Subbaum noch aussteht) auf einem eigenen Stack. Ein Durchlauf kostet insgesamt O(n).
+// Der Iterator wird durch jede Änderung des Treaps ungültig.
+template<class K, class P, template<class> class Allocator, bool SubtreeSizes>
+class Treap<K, P, Allocator, SubtreeSizes>::const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = const Entry&;
+
+    // End-Iterator.
+    const_iterator() noexcept = default;
+
+    [[nodiscard]] auto operator*() const noexcept -> reference
+    {
+        return treap_->at(path_.back());
+    }
+
+    [[nodiscard]] auto operator->() const noexcept -> pointer
+    {
+        return &treap_->at(path_.back());
+    }
+
+    auto operator++() noexcept -> const_iterator&
+    {
+        const auto right = treap_->at(path_.back()).right;
+        path_.pop_back();
+        descend(right);
+        return *this;
+    }
+
+    auto operator++(int) noexcept -> const_iterator
+    {
+        auto old = *this;
+        ++*this;
+        return old;
+    }
+
+    [[nodiscard]] auto operator==(const const_iterator& other) const noexcept -> bool
+    {
+        // clang-format off
+        if(path_.empty() || other.path_.empty()) return path_.empty() == other.path_.empty();
+        // clang-format on
+        return path_.back() == other.path_.back();
+    }
+
+private:
+    friend class Treap;
+
+    const_iterator(const Treap* treap, Link root) noexcept
+        : treap_(treap)
+    {
+        descend(root);
+    }
+
+    // Steigt von 'node' aus ganz nach links ab und merkt sich den Pfad.
+    auto descend(Link node) noexcept -> void
+    {
+        while(node != null) {
+            path_.push_back(node);
+            node = treap_->at(node).left;
+        }
+    }
+
+    const Treap* treap_ = nullptr; // Treap, über den iteriert wird.
+    std::vector<Link> path_;       // Knoten, deren Schlüssel und rechter Subbaum noch ausstehen; oben der aktuelle.
+};
+
+// Treap mit Knoten in einer SlabArena (Zeiger) bzw. IndexArena (32-Bit-Indizes).
+// Als Alias mit nur Schlüssel und Priorität lassen sie sich als Puffer-Container an KnuthSketch und knuth_cvm übergeben.
+template<class K, class P>
+using SlabTreap = Treap<K, P, SlabArena>;
+
+template<class K, class P>
+using IndexTreap = Treap<K, P, IndexArena>;
+
 } // namespace cvm
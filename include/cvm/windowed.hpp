@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/random.hpp>
+#include <cvm/treap.hpp>
+
+namespace cvm {
+
+// Zählt die verschiedenen Elemente in einem gleitenden Zeitfenster, z.B. "verschiedene Nutzer der letzten 5 Minuten".
+//
+// Die Zeitachse wird in Epochen der Länge ceil(window / epochs) geteilt. Für jede Epoche gibt es einen eigenen
+// KnuthSketch in einem Ring aus epochs + 1 Sketches, eine neue Epoche überschreibt den ältesten. Eine Abfrage vereinigt
+// die Sketches der aktuellen und der 'epochs' vorherigen Epochen (siehe KnuthSketch::merge) und deckt damit mindestens
+// 'window' und höchstens window + window / epochs Zeiteinheiten ab. Mehr Epochen machen die Grenze des Fensters genauer,
+// die Abfrage aber teurer. Der Speicher ist durch (epochs + 1) * s gepufferte Elemente beschränkt.
+//
+// Alle Sketches teilen sich einen Seed (Priorities::hashed), daher ist die Vereinigung exakt, auch wenn ein Element
+// in mehreren Epochen vorkommt: Das Ergebnis ist der Sketch, den ein einzelner Durchlauf über alle Elemente des
+// Fensters ergeben hätte. Pro Element kommt zu KnuthSketch::add nur die Bestimmung der Epoche hinzu.
+//
+// Zeitstempel sind vorzeichenlose Ganzzahlen in einer beliebigen Einheit. Sie sollten ungefähr aufsteigend sein:
+// Verspätete Elemente landen in ihrer Epoche, solange diese noch im Ring liegt, ältere werden verworfen.
+template<class T, template<class, class> class Buffer = SlabTreap, std::uniform_random_bit_generator Rng = WyRand>
+class WindowedSketch
+{
+public:
+    // Typ der Sketches pro Epoche.
+    using SketchType = KnuthSketch<T, Buffer, Priorities::hashed, Rng>;
+
+    // Erzeugt einen leeren Sketch für ein Fenster von 'window' Zeiteinheiten, geteilt in 'epochs' Epochen,
+    // mit Puffergröße s pro Epoche. window und epochs werden auf mindestens 1 angehoben.
+    WindowedSketch(std::size_t s, std::uint64_t window, std::size_t epochs, Rng rng = Rng{random_seed()}) noexcept
+    {
+        window = std::max<std::uint64_t>(window, 1);
+        epochs = std::max<std::size_t>(epochs, 1);
+        epoch_length_ = (window + epochs - 1) / epochs;
+
+        auto first = SketchType(s, std::move(rng));
+        ring_.reserve(epochs + 1);
+        for(std::size_t i = 0; i < epochs; i++) {
+            ring_.push_back(Slot{first.empty_copy(), 0});
+        }
+        ring_.push_back(Slot{std::move(first), 0});
+    }
+
+    // Verarbeitet ein Element mit Zeitstempel 'time'.
+    auto add(const T& elem, std::uint64_t time) noexcept -> void
+    {
+        if(auto* sketch = sketch_for(time)) {
+            sketch->add(elem);
+        }
+    }
+
+    // Verarbeitet einen Block von Elementen mit demselben Zeitstempel.
+    auto add_batch(std::span<const T> elems, std::uint64_t time) noexcept -> void
+    {
+        if(auto* sketch = sketch_for(time)) {
+            sketch->add_batch(elems);
+        }
+    }
+
+    // Schiebt das Fenster bis 'time' weiter, ohne ein Element hinzuzufügen.
+    // Damit veralten Elemente auch in ruhigen Phasen, in denen keine neuen Elemente kommen.
+    auto advance(std::uint64_t time) noexcept -> void
+    {
+        current_ = std::max(current_, time / epoch_length_);
+    }
+
+    // Vereinigt die Sketches aller Epochen im Fenster, das mit dem neuesten Zeitstempel endet.
+    [[nodiscard]] auto window_sketch() const noexcept -> SketchType
+    {
+        auto result = ring_.front().sketch.empty_copy();
+        for(const auto& slot : ring_) {
+            if(in_window(slot)) {
+                result.merge(slot.sketch);
+            }
+        }
+        return result;
+    }
+
+    // Schätzung der Anzahl verschiedener Elemente im Fenster. Kostet eine Vereinigung von epochs + 1 Sketches.
+    [[nodiscard]] auto estimate() const noexcept -> double
+    {
+        return window_sketch().estimate();
+    }
+
+    // Länge einer Epoche in Zeiteinheiten.
+    [[nodiscard]] auto epoch_length() const noexcept -> std::uint64_t
+    {
+        return epoch_length_;
+    }
+
+    // Anzahl der Elemente in allen Puffern zusammen.
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        std::size_t total = 0;
+        for(const auto& slot : ring_) {
+            total += slot.sketch.size();
+        }
+        return total;
+    }
+
+private:
+    // Sketch einer Epoche im Ring.
+    struct Slot
+    {
+        SketchType sketch;
+        std::uint64_t epoch; // Epoche, deren Elemente 'sketch' enthält.
+    };
+
+    // Liegt die Epoche des Slots im Fenster, das mit der aktuellen Epoche endet?
+    [[nodiscard]] auto in_window(const Slot& slot) const noexcept -> bool
+    {
+        return slot.epoch <= current_ && current_ - slot.epoch < ring_.size();
+    }
+
+    // Sketch der Epoche von 'time', oder nullptr, wenn die Epoche schon aus dem Ring gefallen ist.
+    // Eine neue Epoche übernimmt den Slot der ältesten und beginnt mit einem leeren Sketch.
+    [[nodiscard]] auto sketch_for(std::uint64_t time) noexcept -> SketchType*
+    {
+        const auto epoch = time / epoch_length_;
+        // clang-format off
+        if(epoch + ring_.size() <= current_) return nullptr;
+        // clang-format on
+        current_ = std::max(current_, epoch);
+
+        auto& slot = ring_[epoch % ring_.size()];
+        if(slot.epoch != epoch) {
+            slot.sketch = slot.sketch.empty_copy();
+            slot.epoch = epoch;
+        }
+        return &slot.sketch;
+    }
+
+    std::vector<Slot> ring_;         // Sketches der letzten epochs + 1 Epochen, Epoche e liegt in ring_[e % ring_.size()].
+    std::uint64_t epoch_length_ = 1; // Länge einer Epoche in Zeiteinheiten.
+    std::uint64_t current_ = 0;      // Neueste Epoche, bis zu der das Fenster reicht.
+};
+
+} // namespace cvm
@@ -0,0 +1,60 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cvm/concurrent.hpp>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Leser sehen während des Schreibens nur konsistente Momentaufnahmen (size <= s, 0 < p <= 1, bei p = 1 nie mehr
+// Elemente als bisher geschrieben) und nach dem Ende genau den Zustand des inneren Sketches.
+TEST(ConcurrentTests, ReadersSeeConsistentSnapshots)
+{
+    const std::size_t s = 1000;
+    const std::size_t n = 2000000;
+    std::vector<std::uint64_t> stream(n);
+    cvm::WyRand rng(1);
+    for(auto& x : stream) {
+        x = rng() % 500000;
+    }
+
+    cvm::ConcurrentSketch sketch(cvm::KnuthSketch<std::uint64_t>(s, cvm::WyRand{2}));
+    EXPECT_DOUBLE_EQ(sketch.estimate(), 0);
+
+    std::atomic<bool> done = false;
+    std::atomic<std::size_t> written = 0;
+    std::atomic<std::size_t> invalid = 0;
+    std::vector<std::jthread> readers;
+    for(int r = 0; r < 3; r++) {
+        readers.emplace_back([&] {
+            while(!done.load(std::memory_order_acquire)) {
+                const auto bound = written.load(std::memory_order_acquire);
+                const auto snapshot = sketch.snapshot();
+                if(snapshot.size > s || !(snapshot.p > 0 && snapshot.p <= 1)) {
+                    invalid++;
+                }
+                if(!(snapshot.p < 1) && snapshot.size > bound + 1) {
+                    invalid++;
+                }
+            }
+        });
+    }
+
+    for(std::size_t offset = 0; offset < n; offset += 10000) {
+        sketch.add_batch(std::span<const std::uint64_t>(stream).subspan(offset, 10000));
+        written.store(offset + 10000, std::memory_order_release);
+    }
+    for(std::size_t i = 0; i < 1000; i++) {
+        sketch.add(stream[i]);
+    }
+    done = true;
+    readers.clear();
+
+    EXPECT_EQ(invalid, 0);
+    EXPECT_DOUBLE_EQ(sketch.estimate(), sketch.sketch().estimate());
+    EXPECT_EQ(sketch.snapshot().size, sketch.sketch().size());
+    EXPECT_DOUBLE_EQ(sketch.snapshot().p, sketch.sketch().probability());
+}
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <cstdint>
+#include <cvm/adaptive.hpp>
+#include <cvm/bitmap.hpp>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/cvm_naive.hpp>
+#include <cvm/parallel.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <list>
+#include <span>
+#include <vector>
+
+// Erzeugt einen reproduzierbaren Stream mit vielen Wiederholungen.
+static auto make_stream(std::size_t n, std::uint32_t domain, std::uint64_t seed) -> std::vector<std::uint32_t>
+{
+    cvm::WyRand rng(seed);
+    std::vector<std::uint32_t> stream(n);
+    for(auto& x : stream) {
+        x = static_cast<std::uint32_t>(rng() % domain);
+    }
+    return stream;
+}
+
+// Exakte Anzahl verschiedener Elemente als Referenz.
+static auto exact_distinct(std::vector<std::uint32_t> stream) -> double
+{
+    std::sort(stream.begin(), stream.end());
+    return static_cast<double>(std::unique(stream.begin(), stream.end()) - stream.begin());
+}
+
+
+// Gleicher Seed ergibt die gleiche Zufallsfolge, verschiedene Seeds verschiedene Folgen.
+TEST(RandomTests, SeededGeneratorIsReproducible)
+{
+    cvm::WyRand a(42);
+    cvm::WyRand b(42);
+    cvm::WyRand c(43);
+
+    for(int i = 0; i < 100; i++) {
+        const auto x = a();
+        EXPECT_EQ(x, b());
+        EXPECT_NE(x, c());
+    }
+
+    // Die Umwandlung in ein Double bleibt immer in [0, 1).
+    EXPECT_EQ(cvm::to_unit_double(0), 0.0);
+    EXPECT_LT(cvm::to_unit_double(~std::uint64_t{0}), 1.0);
+}
+
+// Mit festem Seed liefern beide Algorithmen bei jedem Lauf dasselbe Ergebnis.
+TEST(CvmTests, SeededRunsAreReproducible)
+{
+    const auto stream = make_stream(100000, 50000, 1);
+
+    EXPECT_EQ(cvm::knuth_cvm(stream.begin(), stream.end(), 1000, cvm::WyRand{7}),
+              cvm::knuth_cvm(stream.begin(), stream.end(), 1000, cvm::WyRand{7}));
+    EXPECT_EQ(cvm::naive_cvm(stream.begin(), stream.end(), 0.5, 0.01, cvm::WyRand{7}),
+              cvm::naive_cvm(stream.begin(), stream.end(), 0.5, 0.01, cvm::WyRand{7}));
+}
+
+// Schlüssel mit höchstens 16 Bit werden über eine Bitmap exakt gezählt, auch über Listen-Iteratoren.
+TEST(CvmTests, NarrowKeysAreCountedExactly)
+{
+    const auto stream = make_stream(100000, 50000, 2);
+    const std::vector<std::uint16_t> u16(stream.begin(), stream.end());
+    std::vector<std::int8_t> i8(stream.size());
+    std::transform(stream.begin(), stream.end(), i8.begin(), [](std::uint32_t x) { return static_cast<std::int8_t>(x % 200 - 100); });
+
+    EXPECT_EQ(cvm::knuth_cvm(u16.begin(), u16.end(), 1000), exact_distinct(stream));
+    EXPECT_EQ(cvm::naive_cvm(u16.begin(), u16.end(), 0.5, 0.01), exact_distinct(stream));
+    EXPECT_EQ(cvm::knuth_cvm(i8.begin(), i8.end(), 10), 200);
+
+    const std::list<std::int8_t> list(i8.begin(), i8.end());
+    EXPECT_EQ(cvm::naive_cvm(list.begin(), list.end(), 0.5, 0.01), 200);
+
+    cvm::BitmapCounter<std::uint8_t> counter;
+    EXPECT_EQ(counter.count(), 0);
+    for(unsigned x = 0; x < 256; x++) {
+        EXPECT_FALSE(counter.full());
+        counter.add(static_cast<std::uint8_t>(x));
+    }
+    EXPECT_TRUE(counter.full());
+    EXPECT_EQ(counter.count(), 256);
+}
+
+// Der Mittelwert über mehrere Läufe liegt nahe an der exakten Anzahl verschiedener Elemente.
+TEST(CvmTests, EstimatesAreAccurate)
+{
+    const auto stream = make_stream(200000, 100000, 2);
+    const auto exact = exact_distinct(stream);
+
+    double knuth = 0;
+    double naive = 0;
+    const int runs = 20;
+    for(int i = 0; i < runs; i++) {
+        knuth += cvm::knuth_cvm(stream.begin(), stream.end(), 2000, cvm::WyRand(i)).value();
+        naive += cvm::naive_cvm(stream.begin(), stream.end(), 0.5, 0.01, cvm::WyRand(i)).value();
+    }
+
+    EXPECT_NEAR(knuth / runs, exact, 0.03 * exact);
+    EXPECT_NEAR(naive / runs, exact, 0.05 * exact);
+}
+
+// Generator, der zählt, wie oft er aufgerufen wurde.
+class CountingRng
+{
+public:
+    using result_type = std::uint64_t;
+
+    CountingRng(std::uint64_t seed, std::size_t& calls)
+        : rng_(seed),
+          calls_(&calls)
+    {
+    }
+
+    auto operator()() -> result_type
+    {
+        ++*calls_;
+        return rng_();
+    }
+
+    constexpr static auto min() -> result_type
+    {
+        return cvm::WyRand::min();
+    }
+
+    constexpr static auto max() -> result_type
+    {
+        return cvm::WyRand::max();
+    }
+
+private:
+    cvm::WyRand rng_;
+    std::size_t* calls_;
+};
+
+// Die geometrischen Sprünge brauchen ein Vielfaches weniger Zufallszahlen als ein Münzwurf pro Element,
+// bei gleicher Genauigkeit.
+TEST(CvmTests, GeometricSamplingNeedsFewerRandomDraws)
+{
+    const auto stream = make_stream(1000000, 500000, 3);
+    const auto exact = exact_distinct(stream);
+
+    std::size_t bernoulli_calls = 0;
+    std::size_t geometric_calls = 0;
+    double bernoulli = 0;
+    double geometric = 0;
+    const int runs = 5;
+    for(int i = 0; i < runs; i++) {
+        bernoulli += cvm::naive_cvm<cvm::Sampling::bernoulli>(stream.begin(), stream.end(), 0.5, 0.01, CountingRng(i, bernoulli_calls)).value();
+        geometric += cvm::naive_cvm<cvm::Sampling::geometric>(stream.begin(), stream.end(), 0.5, 0.01, CountingRng(i, geometric_calls)).value();
+    }
+
+    EXPECT_LT(4 * geometric_calls, bernoulli_calls);
+    EXPECT_NEAR(bernoulli / runs, exact, 0.1 * exact);
+    EXPECT_NEAR(geometric / runs, exact, 0.1 * exact);
+}
+
+// Der GeometricSampler liefert Erfolge mit der eingestellten Wahrscheinlichkeit.
+TEST(RandomTests, GeometricSamplerMatchesProbability)
+{
+    cvm::WyRand rng(5);
+    cvm::GeometricSampler sampler;
+    sampler.set_probability(0.01, rng);
+
+    std::size_t hits = 0;
+    const std::size_t trials = 1000000;
+    for(std::size_t i = 0; i < trials; i++) {
+        hits += sampler(rng) ? 1 : 0;
+    }
+
+    EXPECT_NEAR(static_cast<double>(hits) / trials, 0.01, 0.001);
+}
+
+// Die Sketches liefern mit gleichem Seed dasselbe Ergebnis wie die Funktionen über den ganzen Stream,
+// egal ob die Elemente einzeln oder blockweise hinzugefügt werden.
+TEST(SketchTests, MatchesOneShotFunctions)
+{
+    const auto stream = make_stream(100000, 50000, 4);
+    const std::span<const std::uint32_t> all(stream);
+
+    cvm::KnuthSketch<std::uint32_t> knuth(1000, cvm::WyRand{9});
+    knuth.add_batch(all.first(30000));
+    for(const auto x : all.subspan(30000)) {
+        knuth.add(x);
+    }
+    EXPECT_EQ(knuth.estimate(), cvm::knuth_cvm(stream.begin(), stream.end(), 1000, cvm::WyRand{9}));
+
+    cvm::NaiveSketch<std::uint32_t> naive(0.5, 0.01, stream.size(), cvm::WyRand{9});
+    EXPECT_TRUE(naive.add_batch(all));
+    EXPECT_EQ(naive.estimate(), cvm::naive_cvm(stream.begin(), stream.end(), 0.5, 0.01, cvm::WyRand{9}));
+}
+
+// add_batch lädt bei großen Puffern vorab, wendet die Updates aber in derselben Reihenfolge an wie add.
+template<template<class, class> class Buffer>
+static auto expect_batch_matches_add() -> void
+{
+    const auto stream = make_stream(200000, 100000, 8);
+
+    cvm::KnuthSketch<std::uint32_t, Buffer> single(30000, cvm::WyRand{13});
+    for(const auto x : stream) {
+        single.add(x);
+    }
+
+    cvm::KnuthSketch<std::uint32_t, Buffer> batch(30000, cvm::WyRand{13});
+    batch.add_batch(stream);
+
+    EXPECT_EQ(batch.size(), single.size());
+    EXPECT_EQ(batch.probability(), single.probability());
+}
+
+TEST(SketchTests, PrefetchingBatchMatchesSingleUpdates)
+{
+    expect_batch_matches_add<cvm::SlabTreap>();
+    expect_batch_matches_add<cvm::IndexTreap>();
+    expect_batch_matches_add<cvm::IndexedHeap>();
+}
+
+// Ohne bekannte Länge wächst der Schwellenwert mit dem Stream und die Schätzung ist jederzeit abrufbar.
+TEST(SketchTests, DoublingScheduleWithoutLength)
+{
+    const auto stream = make_stream(400000, 200000, 5);
+    const std::span<const std::uint32_t> all(stream);
+
+    cvm::NaiveSketch<std::uint32_t> naive(0.5, 0.01, cvm::WyRand{11});
+    cvm::KnuthSketch<std::uint32_t> knuth(2000, cvm::WyRand{11});
+
+    const auto initial_threshold = naive.threshold();
+    for(std::size_t offset = 0; offset < stream.size(); offset += 100000) {
+        const auto block = all.subspan(offset, 100000);
+        ASSERT_TRUE(naive.add_batch(block));
+        knuth.add_batch(block);
+
+        const auto exact = exact_distinct({stream.begin(), stream.begin() + offset + 100000});
+        EXPECT_NEAR(naive.estimate().value(), exact, 0.2 * exact);
+        EXPECT_NEAR(knuth.estimate(), exact, 0.2 * exact);
+    }
+
+    EXPECT_GT(naive.threshold(), initial_threshold);
+    EXPECT_LT(naive.size(), naive.threshold());
+}
+
+// Nach Hash partitionierte Teilstreams lassen sich zu einem Sketch vereinigen, dessen Schätzung im Mittel
+// genauso gut ist wie die eines einzelnen Durchlaufs über den ganzen Stream.
+TEST(SketchTests, MergedShardsMatchSequentialRun)
+{
+    const auto stream = make_stream(200000, 100000, 6);
+    const auto exact = exact_distinct(stream);
+
+    const int shards = 4;
+    std::vector<std::vector<std::uint32_t>> parts(shards);
+    for(const auto x : stream) {
+        parts[cvm::mix64(x) % shards].push_back(x);
+    }
+
+    double merged = 0;
+    double sequential = 0;
+    const int runs = 20;
+    for(int i = 0; i < runs; i++) {
+        cvm::KnuthSketch<std::uint32_t> total(2000, cvm::WyRand(100 + i));
+        for(int k = 0; k < shards; k++) {
+            cvm::KnuthSketch<std::uint32_t> part(2000, cvm::WyRand(1000 * i + k));
+            part.add_batch(parts[k]);
+            total.merge(part);
+        }
+
+        EXPECT_LE(total.size(), total.capacity());
+        merged += total.estimate();
+        sequential += cvm::knuth_cvm(stream.begin(), stream.end(), 2000, cvm::WyRand(i)).value();
+    }
+
+    EXPECT_NEAR(merged / runs, exact, 0.03 * exact);
+    EXPECT_NEAR(sequential / runs, exact, 0.03 * exact);
+}
+
+// Ein Sketch über den ersten Teil eines Streams, vereinigt mit einem leeren Sketch, bleibt unverändert.
+// Umgekehrt übernimmt ein leerer Sketch den Zustand des anderen vollständig.
+TEST(SketchTests, MergeWithEmptySketch)
+{
+    const auto stream = make_stream(50000, 20000, 7);
+
+    cvm::KnuthSketch<std::uint32_t> full(500, cvm::WyRand{1});
+    full.add_batch(stream);
+    const auto before = full.estimate();
+
+    full.merge(cvm::KnuthSketch<std::uint32_t>(500, cvm::WyRand{2}));
+    EXPECT_EQ(full.estimate(), before);
+
+    cvm::KnuthSketch<std::uint32_t> empty(500, cvm::WyRand{3});
+    empty.merge(full);
+    EXPECT_EQ(empty.estimate(), before);
+    EXPECT_EQ(empty.size(), full.size());
+}
+
+// Die parallelen Varianten sind bei festem Seed und fester Thread-Anzahl reproduzierbar
+// und im Mittel genauso genau wie die sequentiellen.
+TEST(ParallelTests, EstimatesAreAccurate)
+{
+    const auto stream = make_stream(200000, 100000, 8);
+    const auto exact = exact_distinct(stream);
+
+    for(const std::size_t threads : {1, 2, 3, 4}) {
+        EXPECT_EQ(cvm::parallel_knuth_cvm(stream.begin(), stream.end(), 2000, threads, 5),
+                  cvm::parallel_knuth_cvm(stream.begin(), stream.end(), 2000, threads, 5));
+
+        double knuth = 0;
+        double naive = 0;
+        const int runs = 10;
+        for(int i = 0; i < runs; i++) {
+            knuth += cvm::parallel_knuth_cvm(stream.begin(), stream.end(), 2000, threads, i).value();
+            naive += cvm::parallel_naive_cvm(stream.begin(), stream.end(), 0.5, 0.01, threads, i).value();
+        }
+
+        EXPECT_NEAR(knuth / runs, exact, 0.05 * exact) << threads << " threads";
+        EXPECT_NEAR(naive / runs, exact, 0.1 * exact) << threads << " threads";
+    }
+}
+
+// Bis zu s verschiedenen Elementen zählt AdaptiveSketch exakt. Danach stimmt es bei Prioritäten aus einem Hash genau
+// mit KnuthSketch überein und liegt bei zufälligen Prioritäten im Mittel nahe an der exakten Anzahl.
+TEST(AdaptiveTests, ExactUntilBufferFillsThenSampled)
+{
+    const auto small = make_stream(100000, 1500, 3);
+    EXPECT_EQ(cvm::adaptive_knuth_cvm(small.begin(), small.end(), 2000), exact_distinct(small));
+
+    const auto stream = make_stream(200000, 100000, 4);
+    const auto exact = exact_distinct(stream);
+
+    using Hashed = cvm::KnuthSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    double mean = 0;
+    const int runs = 20;
+    for(int i = 0; i < runs; i++) {
+        cvm::AdaptiveSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed> adaptive(2000, cvm::WyRand(i));
+        Hashed knuth(2000, cvm::WyRand(i));
+        adaptive.add_batch(std::span(stream).first(1000));
+        EXPECT_TRUE(adaptive.exact());
+        adaptive.add_batch(std::span(stream).subspan(1000));
+        knuth.add_batch(stream);
+        EXPECT_FALSE(adaptive.exact());
+        EXPECT_EQ(adaptive.estimate(), knuth.estimate());
+
+        mean += cvm::adaptive_knuth_cvm<cvm::IndexedHeap>(stream.begin(), stream.end(), 2000, cvm::WyRand(i)).value();
+    }
+
+    EXPECT_NEAR(mean / runs, exact, 0.03 * exact);
+}
+
+// Mit Prioritäten aus einem Hash hängt das Ergebnis nur von der Menge der verschiedenen Elemente ab:
+// Der sortierte Stream ohne Wiederholungen ergibt bei gleichem Seed genau dieselbe Schätzung.
+TEST(HashedPriorityTests, IgnoresOrderAndRepeats)
+{
+    auto stream = make_stream(100000, 30000, 9);
+    const auto exact = exact_distinct(stream);
+
+    auto distinct = stream;
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    using Sketch = cvm::KnuthSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    double mean = 0;
+    const int runs = 20;
+    for(int i = 0; i < runs; i++) {
+        Sketch a(1000, cvm::WyRand(i));
+        Sketch b(1000, cvm::WyRand(i));
+        a.add_batch(stream);
+        b.add_batch(distinct);
+        EXPECT_EQ(a.estimate(), b.estimate());
+        EXPECT_EQ(a.estimate(), (cvm::knuth_cvm<cvm::SlabTreap, cvm::Priorities::hashed>(stream.begin(), stream.end(), 1000, cvm::WyRand(i))));
+        mean += a.estimate();
+    }
+
+    EXPECT_NEAR(mean / runs, exact, 0.03 * exact);
+}
+
+// Mit gleichem Seed lassen sich auch Sketches über überlappende Teilstreams exakt vereinigen.
+TEST(HashedPriorityTests, OverlappingShardsMergeExactly)
+{
+    const auto stream = make_stream(100000, 30000, 10);
+    const std::span<const std::uint32_t> all(stream);
+
+    using Sketch = cvm::KnuthSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    Sketch full(1000, cvm::WyRand{12});
+    full.add_batch(all);
+
+    auto first = full.empty_copy();
+    auto second = full.empty_copy();
+    first.add_batch(all.first(60000));
+    second.add_batch(all.last(60000));
+    first.merge(second);
+
+    EXPECT_EQ(first.estimate(), full.estimate());
+    EXPECT_EQ(first.size(), full.size());
+}
+
+// Aus zwei Sketches mit gleichem Seed lässt sich auch die Anzahl der gemeinsamen Elemente schätzen.
+TEST(HashedPriorityTests, IntersectionEstimate)
+{
+    using Sketch = cvm::KnuthSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+
+    // A = [0, 300000), B = [200000, 400000): 100000 gemeinsame Elemente.
+    Sketch a(5000, cvm::WyRand{21});
+    auto b = a.empty_copy();
+    for(std::uint32_t x = 0; x < 300000; x++) {
+        a.add(x);
+    }
+    for(std::uint32_t x = 200000; x < 400000; x++) {
+        b.add(x);
+    }
+
+    EXPECT_NEAR(a.intersection_estimate(b), 100000, 10000);
+    EXPECT_EQ(a.intersection_estimate(b), b.intersection_estimate(a));
+
+    auto both = a;
+    both.merge(b);
+    EXPECT_NEAR(both.estimate(), 400000, 40000);
+}
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <cvm/flat_set.hpp>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+using cvm::FlatSet;
+
+
+// Ein Test für Einfügen, Suchen und Löschen im Hashset.
+TEST(FlatSetTests, InsertContainsErase)
+{
+    FlatSet<int> set(4);
+
+    EXPECT_TRUE(set.insert(5));
+    EXPECT_TRUE(set.insert(2));
+
+    // Doppelte Elemente werden nicht eingefügt.
+    EXPECT_FALSE(set.insert(5));
+    EXPECT_EQ(set.size(), 2);
+
+    EXPECT_TRUE(set.contains(2));
+    EXPECT_FALSE(set.contains(8));
+
+    EXPECT_TRUE(set.erase(2));
+    EXPECT_FALSE(set.erase(2));
+    EXPECT_FALSE(set.contains(2));
+    EXPECT_EQ(set.size(), 1);
+}
+
+// Das Set wächst über die reservierte Kapazität hinaus.
+TEST(FlatSetTests, GrowsBeyondCapacity)
+{
+    FlatSet<std::uint32_t> set(2);
+
+    for(std::uint32_t i = 0; i < 1000; i++) {
+        set.insert(i);
+    }
+
+    EXPECT_EQ(set.size(), 1000);
+    for(std::uint32_t i = 0; i < 1000; i++) {
+        EXPECT_TRUE(set.contains(i));
+    }
+}
+
+// Zufällige Operationen werden gegen std::set verglichen, inklusive des Halbierens mit erase_if.
+TEST(FlatSetTests, MatchesStdSet)
+{
+    FlatSet<std::uint16_t> set(512);
+    std::set<std::uint16_t> reference;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::uint16_t> dist(0, 2048);
+
+    for(int round = 0; round < 20; round++) {
+        for(int i = 0; i < 1000; i++) {
+            const auto x = dist(gen);
+            if(gen() % 2) {
+                EXPECT_EQ(set.insert(x), reference.insert(x).second);
+            } else {
+                EXPECT_EQ(set.erase(x), reference.erase(x) == 1);
+            }
+        }
+
+        // Entfernt alle ungeraden Elemente in einem Durchlauf.
+        const auto removed = set.erase_if([](auto x) { return x % 2 == 1; });
+        EXPECT_EQ(removed, std::erase_if(reference, [](auto x) { return x % 2 == 1; }));
+
+        ASSERT_EQ(set.size(), reference.size());
+        for(std::uint16_t x = 0; x <= 2048; x++) {
+            EXPECT_EQ(set.contains(x), reference.contains(x));
+        }
+    }
+}
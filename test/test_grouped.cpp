@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <cstdint>
+#include <cvm/grouped.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+
+// Erzeugt n Paare (Gruppe, Element). Gruppe g hat Elemente aus einem Wertebereich der Größe 1 + g % 500,
+// damit es neben vielen kleinen auch Gruppen gibt, die über die Puffergröße hinauswachsen. Die Elemente verschiedener
+// Gruppen sind verschieden, sonst hätten sie dieselben Prioritäten und die Fehler der Gruppen hingen zusammen.
+static auto make_pairs(std::size_t n, std::uint32_t groups, std::uint64_t seed)
+    -> std::pair<std::vector<std::uint32_t>, std::vector<std::uint64_t>>
+{
+    cvm::WyRand rng(seed);
+    std::vector<std::uint32_t> group_ids(n);
+    std::vector<std::uint64_t> elems(n);
+    for(std::size_t i = 0; i < n; i++) {
+        group_ids[i] = static_cast<std::uint32_t>(rng() % groups);
+        elems[i] = std::uint64_t{group_ids[i]} << 32 | rng() % (1 + group_ids[i] % 500);
+    }
+    return {group_ids, elems};
+}
+
+// Bis s verschiedene Elemente pro Gruppe zählt jede Gruppe exakt, darüber liegt die mittlere Schätzung nahe am
+// exakten Wert. Die partitionierte Verarbeitung in add_batch ergibt dieselben Schätzungen wie einzelne Aufrufe von add.
+TEST(GroupedTests, MatchesSingleUpdatesAndCountsPerGroup)
+{
+    const std::uint32_t groups = 1 << 15;
+    const std::size_t s = 64;
+    const auto [group_ids, elems] = make_pairs(2000000, groups, 1);
+
+    cvm::GroupedSketches<std::uint64_t> batched(groups, s, 7);
+    cvm::GroupedSketches<std::uint64_t> single(groups, s, 7);
+    batched.add_batch(group_ids, elems);
+    for(std::size_t i = 0; i < group_ids.size(); i++) {
+        single.add(group_ids[i], elems[i]);
+    }
+    EXPECT_EQ(batched.estimates(), single.estimates());
+
+    std::vector<std::set<std::uint64_t>> exact(groups);
+    for(std::size_t i = 0; i < group_ids.size(); i++) {
+        exact[group_ids[i]].insert(elems[i]);
+    }
+
+    double estimated_large = 0;
+    double exact_large = 0;
+    for(std::uint32_t g = 0; g < groups; g++) {
+        if(exact[g].size() <= s) {
+            EXPECT_EQ(batched.estimate(g), exact[g].size()) << "group " << g;
+        } else {
+            EXPECT_EQ(batched.size(g), s);
+            estimated_large += batched.estimate(g);
+            exact_large += static_cast<double>(exact[g].size());
+        }
+    }
+    EXPECT_GT(exact_large, 0);
+    EXPECT_NEAR(estimated_large, exact_large, 0.01 * exact_large);
+}
@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <cvm/cvm_naive.hpp>
+#include <cvm/hash.hpp>
+#include <cvm/hashed.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <vector>
+
+// Prüft, dass hash_batch für jeden Schlüssel dasselbe liefert wie Hash<K>, auch für Reste, die nicht in einen
+// ganzen SIMD-Block passen.
+template<class K>
+static auto check_batch_matches_scalar(const std::vector<K>& keys) -> void
+{
+    std::vector<std::uint64_t> out(keys.size());
+    cvm::hash_batch(std::span<const K>(keys), std::span<std::uint64_t>(out));
+    for(std::size_t i = 0; i < keys.size(); i++) {
+        EXPECT_EQ(out[i], cvm::Hash<K>{}(keys[i])) << i;
+    }
+}
+
+TEST(HashTests, BatchMatchesScalar)
+{
+    cvm::WyRand rng(1);
+    std::vector<std::uint64_t> u64(1027);
+    std::vector<std::int64_t> i64(1027);
+    std::vector<std::uint32_t> u32(1027);
+    std::vector<std::int32_t> i32(1027);
+    for(std::size_t i = 0; i < u64.size(); i++) {
+        const auto x = rng();
+        u64[i] = x;
+        i64[i] = static_cast<std::int64_t>(x);
+        u32[i] = static_cast<std::uint32_t>(x);
+        i32[i] = static_cast<std::int32_t>(x);
+    }
+
+    check_batch_matches_scalar(u64);
+    check_batch_matches_scalar(i64);
+    check_batch_matches_scalar(u32);
+    check_batch_matches_scalar(i32);
+    check_batch_matches_scalar(std::vector<std::string>{"", "a", "ab", "abcd", "hello world", "a longer string than sixteen bytes"});
+}
+
+// Zeichenketten aller Längen bis 64 Bytes, die sich nur in einem Byte oder der Länge unterscheiden, kollidieren nicht.
+TEST(HashTests, StringsOfAllLengths)
+{
+    std::set<std::uint64_t> seen;
+    std::size_t count = 0;
+    for(std::size_t len = 0; len <= 64; len++) {
+        std::string base(len, 'x');
+        seen.insert(cvm::Hash<std::string>{}(base));
+        count++;
+        for(std::size_t pos = 0; pos < len; pos++) {
+            auto changed = base;
+            changed[pos] = 'y';
+            seen.insert(cvm::Hash<std::string>{}(changed));
+            count++;
+        }
+    }
+
+    EXPECT_EQ(seen.size(), count);
+
+    // std::string und std::string_view ergeben denselben Hash.
+    EXPECT_EQ(cvm::Hash<std::string>{}("cvm"), cvm::Hash<std::string_view>{}("cvm"));
+}
+
+// Die Hash-Stufe liefert dasselbe Ergebnis wie ein Sketch, der direkt mit den Fingerabdrücken gefüttert wird,
+// und schätzt Zeichenketten genauso gut wie Ganzzahlen.
+TEST(HashTests, HashedSketchOverStrings)
+{
+    cvm::WyRand rng(2);
+    std::vector<std::string> stream(100000);
+    for(auto& x : stream) {
+        x = "user-" + std::to_string(rng() % 30000);
+    }
+    const auto exact = static_cast<double>(std::set<std::string>(stream.begin(), stream.end()).size());
+
+    cvm::HashedSketch<std::string> hashed(cvm::KnuthSketch<std::uint64_t>(1000, cvm::WyRand{3}));
+    hashed.add_batch(stream);
+
+    cvm::KnuthSketch<std::uint64_t> direct(1000, cvm::WyRand{3});
+    for(const auto& x : stream) {
+        direct.add(cvm::Hash<std::string>{}(x));
+    }
+
+    EXPECT_EQ(hashed.estimate(), direct.estimate());
+    EXPECT_NEAR(hashed.estimate(), exact, 0.15 * exact);
+
+    cvm::HashedSketch<std::string, cvm::NaiveSketch<std::uint64_t>> naive(cvm::NaiveSketch<std::uint64_t>(0.5, 0.01, stream.size(), cvm::WyRand{4}));
+    EXPECT_TRUE(naive.add_batch(stream));
+    EXPECT_NEAR(naive.estimate().value(), exact, 0.3 * exact);
+}
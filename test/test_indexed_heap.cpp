@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstdint>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/indexed_heap.hpp>
+#include <cvm/treap.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+
+using cvm::IndexedHeap;
+
+// Grundlegende Operationen: Einfügen, Suchen, Löschen und Entnehmen in absteigender Priorität.
+TEST(IndexedHeapTests, InsertDeletePop)
+{
+    IndexedHeap<int, double> heap;
+    EXPECT_TRUE(heap.insert(5, 0.5));
+    EXPECT_TRUE(heap.insert(2, 0.9));
+    EXPECT_TRUE(heap.insert(8, 0.1));
+    EXPECT_FALSE(heap.insert(5, 0.7));
+    EXPECT_EQ(heap.size(), 3);
+
+    EXPECT_EQ(heap.top(), (std::pair{2, 0.9}));
+    EXPECT_TRUE(heap.delete_elem(2));
+    EXPECT_FALSE(heap.delete_elem(2));
+    EXPECT_FALSE(heap.contains(2));
+    EXPECT_TRUE(heap.contains(8));
+
+    EXPECT_EQ(heap.pop(), (std::pair{5, 0.5}));
+    EXPECT_EQ(heap.pop(), (std::pair{8, 0.1}));
+    EXPECT_FALSE(heap.pop().has_value());
+    EXPECT_TRUE(heap.empty());
+}
+
+// Zufällige Folgen von Operationen (inklusive Wachstum der Tabelle) verhalten sich wie eine std::map.
+TEST(IndexedHeapTests, MatchesStdMap)
+{
+    IndexedHeap<std::uint32_t, double> heap;
+    std::map<std::uint32_t, double> reference;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    for(int i = 0; i < 100000; i++) {
+        const auto key = static_cast<std::uint32_t>(gen() % 3000);
+        switch(gen() % 4) {
+            case 0:
+            case 1: {
+                const auto prio = uniform(gen);
+                EXPECT_EQ(heap.insert(key, prio), reference.emplace(key, prio).second);
+                break;
+            }
+            case 2:
+                EXPECT_EQ(heap.delete_elem(key), reference.erase(key) == 1);
+                break;
+            case 3: {
+                const auto popped = heap.pop();
+                ASSERT_EQ(popped.has_value(), !reference.empty());
+                if(popped) {
+                    const auto max = std::max_element(reference.begin(), reference.end(),
+                                                      [](const auto& a, const auto& b) { return a.second < b.second; });
+                    EXPECT_EQ(popped->second, max->second);
+                    EXPECT_EQ(popped->first, max->first);
+                    reference.erase(max);
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(heap.size(), reference.size());
+    }
+
+    std::map<std::uint32_t, double> contents;
+    heap.for_each([&](std::uint32_t key, double prio) { contents.emplace(key, prio); });
+    EXPECT_EQ(contents, reference);
+}
+
+// Beide CVM-Schritte liefern dieselbe Schwelle p und denselben Inhalt wie die des Treaps.
+TEST(IndexedHeapTests, CvmStepsMatchTreap)
+{
+    const auto fixed_prio = [](std::uint32_t key) { return cvm::to_unit_double(cvm::mix64(key)); };
+
+    for(const std::size_t s : {1, 10, 300}) {
+        cvm::Treap<std::uint32_t> treap;
+        IndexedHeap<std::uint32_t, double> heap;
+        cvm::Treap<std::uint32_t> treap_fixed;
+        IndexedHeap<std::uint32_t, double> heap_fixed;
+        double pt = 1, ph = 1, pt_fixed = 1, ph_fixed = 1;
+
+        cvm::WyRand rng(s);
+        for(int i = 0; i < 50000; i++) {
+            const auto key = static_cast<std::uint32_t>(rng() % 5000);
+            const auto u = cvm::uniform01(rng);
+            pt = treap.cvm_update(key, u, pt, s);
+            ph = heap.cvm_update(key, u, ph, s);
+            pt_fixed = treap_fixed.cvm_update_fixed(key, fixed_prio(key), pt_fixed, s);
+            ph_fixed = heap_fixed.cvm_update_fixed(key, fixed_prio(key), ph_fixed, s);
+            ASSERT_EQ(pt, ph);
+            ASSERT_EQ(pt_fixed, ph_fixed);
+        }
+
+        const auto contents = [](const auto& buffer) {
+            std::map<std::uint32_t, double> result;
+            buffer.for_each([&](std::uint32_t key, double prio) { result.emplace(key, prio); });
+            return result;
+        };
+        EXPECT_EQ(contents(treap), contents(heap));
+        EXPECT_EQ(contents(treap_fixed), contents(heap_fixed));
+    }
+}
+
+// knuth_cvm liefert mit gleichem Seed unabhängig vom Puffer-Container dasselbe Ergebnis.
+TEST(IndexedHeapTests, KnuthCvmMatchesTreapBuffer)
+{
+    cvm::WyRand rng(2);
+    std::vector<std::uint64_t> stream(200000);
+    for(auto& x : stream) {
+        x = rng() % 100000;
+    }
+
+    EXPECT_EQ(cvm::knuth_cvm<cvm::IndexedHeap>(stream.begin(), stream.end(), 1000, cvm::WyRand{3}),
+              cvm::knuth_cvm<cvm::SlabTreap>(stream.begin(), stream.end(), 1000, cvm::WyRand{3}));
+    EXPECT_EQ(cvm::knuth_cvm<cvm::IndexedHeap>(stream.begin(), stream.end(), 1000, cvm::WyRand{3}),
+              cvm::knuth_cvm<cvm::IndexTreap>(stream.begin(), stream.end(), 1000, cvm::WyRand{3}));
+}
+
+// merge liefert auch bei überlappenden Streams mit zufälligen Prioritäten unabhängig vom Puffer-Container dasselbe
+// Ergebnis: Für gemeinsame Schlüssel gilt in beiden Fällen die Priorität aus 'other'. Mit größerem s hat 'other' das
+// größere p, sodass manche seiner Prioritäten über der neuen Schwelle liegen.
+TEST(IndexedHeapTests, MergeMatchesTreapBuffer)
+{
+    cvm::WyRand rng(4);
+    std::vector<std::uint64_t> first(100000);
+    std::vector<std::uint64_t> second(100000);
+    for(std::size_t i = 0; i < first.size(); i++) {
+        first[i] = rng() % 50000;
+        second[i] = 25000 + rng() % 50000;
+    }
+
+    auto merged = [&]<template<class, class> class Buffer>() {
+        cvm::KnuthSketch<std::uint64_t, Buffer> a(1000, cvm::WyRand{5});
+        cvm::KnuthSketch<std::uint64_t, Buffer> b(5000, cvm::WyRand{6});
+        a.add_batch(first);
+        b.add_batch(second);
+        a.merge(b);
+        return std::pair{a.size(), a.estimate()};
+    };
+
+    EXPECT_EQ((merged.template operator()<cvm::IndexedHeap>()), (merged.template operator()<cvm::SlabTreap>()));
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/ingest.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Eine kleine Ring überträgt eine lange Folge über viele Umläufe vollständig und in Reihenfolge.
+TEST(IngestTests, SpscRingKeepsOrder)
+{
+    cvm::SpscRing<std::uint64_t> ring(50);
+    EXPECT_EQ(ring.capacity(), 64);
+
+    const std::uint64_t n = 200000;
+    std::jthread producer([&] {
+        std::vector<std::uint64_t> block;
+        for(std::uint64_t next = 0; next < n;) {
+            block.clear();
+            for(std::uint64_t i = 0; i < 1 + next % 11 && next + i < n; i++) {
+                block.push_back(next + i);
+            }
+            std::span<const std::uint64_t> rest(block);
+            while(!rest.empty()) {
+                const auto pushed = ring.try_push(rest);
+                rest = rest.subspan(pushed);
+                if(pushed == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            next += block.size();
+        }
+    });
+
+    std::vector<std::uint64_t> out(3);
+    std::uint64_t expected = 0;
+    std::size_t mismatches = 0;
+    while(expected < n) {
+        const auto popped = ring.try_pop(out);
+        if(popped == 0) {
+            std::this_thread::yield();
+        }
+        for(std::size_t i = 0; i < popped; i++) {
+            mismatches += out[i] != expected++;
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+// Mit Prioritäten aus einem Hash hängt das Ergebnis nicht von der Verzahnung der Produzenten ab: Der Sketch stimmt
+// genau mit einem einzelnen Durchlauf über denselben Stream überein.
+TEST(IngestTests, ProducersFeedOneSketch)
+{
+    const std::size_t producers = 4;
+    const std::size_t n = 1000000;
+    std::vector<std::uint64_t> stream(n);
+    cvm::WyRand rng(1);
+    for(auto& x : stream) {
+        x = rng() % 300000;
+    }
+
+    using Sketch = cvm::KnuthSketch<std::uint64_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    Sketch reference(2000, cvm::WyRand{2});
+    reference.add_batch(stream);
+
+    cvm::MultiProducerSketch<std::uint64_t, Sketch> sketch(Sketch(2000, cvm::WyRand{2}), producers, 1000);
+    {
+        std::vector<std::jthread> threads;
+        for(std::size_t t = 0; t < producers; t++) {
+            threads.emplace_back([&, t] {
+                auto& producer = sketch.producer(t);
+                const auto part = std::span<const std::uint64_t>(stream).subspan(t * n / producers, n / producers);
+                // Einzelne Elemente, kleine und große Blöcke gemischt.
+                for(std::size_t i = 0; i < part.size();) {
+                    const auto len = std::min<std::size_t>(part.size() - i, i % 3 == 0 ? 1 : (i % 3 == 1 ? 100 : 5000));
+                    if(len == 1) {
+                        producer.push(part[i]);
+                    } else {
+                        producer.push_batch(part.subspan(i, len));
+                    }
+                    i += len;
+                }
+            });
+        }
+    }
+
+    const auto& result = sketch.finish();
+    EXPECT_EQ(result.size(), reference.size());
+    EXPECT_EQ(result.estimate(), reference.estimate());
+    EXPECT_EQ(sketch.estimate(), reference.estimate());
+}
+
+// Zwischen den Blöcken pausiert der Produzent so lange, dass der Verbraucher blockiert und wieder geweckt werden muss.
+TEST(IngestTests, IdleConsumerWakesUp)
+{
+    using Sketch = cvm::KnuthSketch<std::uint64_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    cvm::MultiProducerSketch<std::uint64_t, Sketch> sketch(Sketch(100, cvm::WyRand{3}), 1, 64);
+    auto& producer = sketch.producer(0);
+    for(std::uint64_t round = 0; round < 5; round++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for(std::uint64_t i = 0; i < 10; i++) {
+            producer.push(round * 10 + i);
+        }
+        producer.flush();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    EXPECT_EQ(sketch.finish().estimate(), 50.0);
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdint>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/cvm_naive.hpp>
+#include <cvm/mapped_file.hpp>
+#include <cvm/parallel.hpp>
+#include <cvm/random.hpp>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Schreibt 'records' als Binärdatei ins temporäre Verzeichnis und gibt den Pfad zurück.
+template<class T>
+static auto write_records(const std::string& name, const std::vector<T>& records, std::size_t extra_bytes = 0)
+    -> std::filesystem::path
+{
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+    for(std::size_t i = 0; i < extra_bytes; i++) {
+        out.put('x');
+    }
+    return path;
+}
+
+TEST(MappedFileTests, RecordsMatchFileContents)
+{
+    cvm::WyRand rng(1);
+    std::vector<std::uint32_t> records(100000);
+    for(auto& x : records) {
+        x = static_cast<std::uint32_t>(rng() % 50000);
+    }
+
+    // Drei überzählige Bytes ergeben keinen ganzen Datensatz und werden ignoriert.
+    const auto path = write_records("cvm_test_records_u32.bin", records, 3);
+    const auto mapped = cvm::MappedRecords<std::uint32_t>::open(path);
+    ASSERT_TRUE(mapped.has_value());
+    ASSERT_EQ(mapped->size(), records.size());
+    EXPECT_TRUE(std::equal(mapped->begin(), mapped->end(), records.begin()));
+
+    // Mit gleichem Seed liefern beide Algorithmen auf der Datei dasselbe wie auf dem Vektor.
+    EXPECT_EQ(cvm::knuth_cvm(mapped->begin(), mapped->end(), 1000, cvm::WyRand{2}),
+              cvm::knuth_cvm(records.begin(), records.end(), 1000, cvm::WyRand{2}));
+    EXPECT_EQ(cvm::naive_cvm(mapped->begin(), mapped->end(), 0.5, 0.01, cvm::WyRand{2}),
+              cvm::naive_cvm(records.begin(), records.end(), 0.5, 0.01, cvm::WyRand{2}));
+    EXPECT_EQ(cvm::parallel_knuth_cvm(mapped->begin(), mapped->end(), 1000, 3, 4),
+              cvm::parallel_knuth_cvm(records.begin(), records.end(), 1000, 3, 4));
+
+    std::filesystem::remove(path);
+}
+
+TEST(MappedFileTests, EmptyAndMissingFiles)
+{
+    const auto path = write_records("cvm_test_records_empty.bin", std::vector<std::uint64_t>{});
+    const auto mapped = cvm::MappedRecords<std::uint64_t>::open(path);
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_TRUE(mapped->empty());
+    EXPECT_EQ(mapped->begin(), mapped->end());
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(cvm::MappedRecords<std::uint64_t>::open(path).has_value());
+}
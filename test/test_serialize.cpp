@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <cstdint>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/random.hpp>
+#include <gtest/gtest.h>
+#include <span>
+#include <vector>
+
+// Erzeugt einen Stream mit Werten aus [-domain / 2, domain / 2).
+template<class T>
+static auto make_stream(std::size_t n, std::uint64_t domain, std::uint64_t seed) -> std::vector<T>
+{
+    cvm::WyRand rng(seed);
+    std::vector<T> stream(n);
+    for(auto& x : stream) {
+        x = static_cast<T>(static_cast<std::int64_t>(rng() % domain) - static_cast<std::int64_t>(domain / 2));
+    }
+    return stream;
+}
+
+// Nach dem Wiederherstellen stimmen s, p und die gepufferten Schlüssel überein, und erneutes Schreiben ergibt
+// dieselben Bytes. Die Prioritäten sind quantisiert, die Schlüssel kosten bei dichtem Wertebereich 1-2 Bytes.
+template<class T, template<class, class> class Buffer>
+static auto check_round_trip() -> void
+{
+    const auto stream = make_stream<T>(200000, 100000, 1);
+
+    cvm::KnuthSketch<T, Buffer> sketch(5000, cvm::WyRand{2});
+    sketch.add_batch(stream);
+    const auto bytes = sketch.serialize();
+    EXPECT_LT(bytes.size(), 40 + sketch.size() * 7);
+
+    const auto restored = cvm::KnuthSketch<T, Buffer>::deserialize(bytes);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->size(), sketch.size());
+    EXPECT_EQ(restored->capacity(), sketch.capacity());
+    EXPECT_EQ(restored->probability(), sketch.probability());
+    EXPECT_EQ(restored->estimate(), sketch.estimate());
+    EXPECT_EQ(restored->serialize(), bytes);
+}
+
+TEST(SerializeTests, RoundTrip)
+{
+    check_round_trip<std::uint32_t, cvm::SlabTreap>();
+    check_round_trip<std::int64_t, cvm::IndexTreap>();
+    check_round_trip<std::int16_t, cvm::IndexedHeap>();
+}
+
+// Mit Priorities::hashed werden die Prioritäten exakt neu berechnet: Ein wiederhergestellter Sketch läuft genau so
+// weiter wie das Original.
+TEST(SerializeTests, HashedSketchContinuesExactly)
+{
+    using Sketch = cvm::KnuthSketch<std::uint64_t, cvm::SlabTreap, cvm::Priorities::hashed>;
+    const auto stream = make_stream<std::uint64_t>(200000, 1000000, 3);
+    const std::span<const std::uint64_t> all(stream);
+
+    Sketch original(2000, cvm::WyRand{4});
+    original.add_batch(all.first(100000));
+
+    auto restored = Sketch::deserialize(original.serialize());
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->seed(), original.seed());
+
+    original.add_batch(all.subspan(100000));
+    restored->add_batch(all.subspan(100000));
+    EXPECT_EQ(restored->estimate(), original.estimate());
+    EXPECT_EQ(restored->serialize(), original.serialize());
+}
+
+// Abgeschnittene, verfälschte oder zu einem anderen Typ gehörende Daten werden abgelehnt.
+TEST(SerializeTests, RejectsInvalidInput)
+{
+    const auto stream = make_stream<std::uint32_t>(10000, 1000, 5);
+    cvm::KnuthSketch<std::uint32_t> sketch(100, cvm::WyRand{6});
+    sketch.add_batch(stream);
+    const auto bytes = sketch.serialize();
+
+    for(std::size_t n = 0; n < bytes.size(); n++) {
+        EXPECT_FALSE(cvm::KnuthSketch<std::uint32_t>::deserialize(std::span(bytes).first(n)).has_value()) << n;
+    }
+
+    auto trailing = bytes;
+    trailing.push_back(std::byte{0});
+    EXPECT_FALSE(cvm::KnuthSketch<std::uint32_t>::deserialize(trailing).has_value());
+
+    auto bad_magic = bytes;
+    bad_magic[0] = std::byte{'X'};
+    EXPECT_FALSE(cvm::KnuthSketch<std::uint32_t>::deserialize(bad_magic).has_value());
+
+    EXPECT_FALSE(cvm::KnuthSketch<std::uint64_t>::deserialize(bytes).has_value());
+    EXPECT_FALSE(cvm::KnuthSketch<std::int32_t>::deserialize(bytes).has_value());
+    EXPECT_FALSE((cvm::KnuthSketch<std::uint32_t, cvm::SlabTreap, cvm::Priorities::hashed>::deserialize(bytes).has_value()));
+}
@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <cvm/treap.hpp>
 #include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
 
 using cvm::Treap;
 
@@ -177,3 +183,380 @@ TEST(TreapTests, MoveConstructor)
     // Stelle sicher, dass das ursprüngliche Treap jetzt leer ist.
     EXPECT_EQ(treap.size(), 0);
 }
+
+
+// Ein Test, der sicherstellt, dass die SlabArena freigegebene Knoten wiederverwendet.
+TEST(TreapTests, SlabArenaReusesNodes)
+{
+    cvm::SlabArena<int> arena(2);
+    EXPECT_EQ(arena.capacity(), 2);
+
+    auto* a = arena.create(1);
+    auto* b = arena.create(2);
+    arena.destroy(a);
+
+    // Der zuletzt freigegebene Slot wird als nächstes vergeben, ohne neuen Slab.
+    auto* c = arena.create(3);
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(*c, 3);
+    EXPECT_EQ(arena.capacity(), 2);
+
+    arena.destroy(b);
+    arena.destroy(c);
+}
+
+// Der Treap funktioniert gleichermaßen mit dem einfachen Heap-Allokator.
+TEST(TreapTests, HeapAllocator)
+{
+    Treap<int, double, cvm::HeapAllocator> treap;
+    treap.insert(5, 100);
+    treap.insert(3, 90);
+    treap.insert(8, 95);
+    treap.delete_elem(3);
+
+    EXPECT_EQ(treap.size(), 2);
+    EXPECT_EQ(treap.pop()->first, 5);
+    EXPECT_EQ(treap.pop()->first, 8);
+    EXPECT_TRUE(treap.empty());
+}
+
+// Der Treap mit 32-Bit-Indizes verhält sich wie der zeigerbasierte Treap.
+TEST(TreapTests, IndexArenaLayout)
+{
+    Treap<std::uint32_t, double, cvm::IndexArena> treap(4);
+    treap.insert(5, 100);
+    treap.insert(3, 90);
+    treap.insert(8, 95);
+    treap.insert(1, 80);
+    treap.insert(7, 85);
+    EXPECT_EQ(treap.size(), 5);
+
+    treap.delete_elem(3);
+    EXPECT_FALSE(treap.contains(3));
+    EXPECT_TRUE(treap.contains(1));
+
+    // Kopie und Original sind unabhängig voneinander.
+    auto copy = treap;
+    copy.insert(9, 10);
+    EXPECT_EQ(copy.size(), 5);
+    EXPECT_EQ(treap.size(), 4);
+
+    EXPECT_EQ(treap.pop()->first, 5);
+    EXPECT_EQ(treap.pop()->first, 8);
+    EXPECT_EQ(treap.pop()->first, 7);
+    EXPECT_EQ(treap.pop()->first, 1);
+    EXPECT_TRUE(treap.empty());
+}
+
+// Zufällige Operationen mit gespeicherten Subbaum-Größen werden gegen std::map verglichen.
+// nth() muss dabei immer den i-kleinsten Schlüssel liefern.
+TEST(TreapTests, SubtreeSizesMatchStdMap)
+{
+    Treap<int, double, cvm::SlabArena, true> treap;
+    std::map<int, double> reference;
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 300);
+
+    for(int i = 0; i < 5000; i++) {
+        const auto x = dist(gen);
+        switch(gen() % 3) {
+        case 0: {
+            const auto prio = decltype(treap)::generate_prio();
+            EXPECT_EQ(treap.insert(x, prio), reference.emplace(x, prio).second);
+            break;
+        }
+        case 1:
+            EXPECT_EQ(treap.delete_elem(x), reference.erase(x) == 1);
+            break;
+        default:
+            if(const auto top = treap.pop()) {
+                // Das Element mit der höchsten Priorität muss im Referenzcontainer existieren.
+                ASSERT_TRUE(reference.contains(top->first));
+                EXPECT_EQ(reference[top->first], top->second);
+                for(const auto& [key, prio] : reference) {
+                    EXPECT_LE(prio, top->second);
+                }
+                reference.erase(top->first);
+            }
+        }
+
+        ASSERT_EQ(treap.size(), reference.size());
+    }
+
+    std::size_t i = 0;
+    for(const auto& [key, prio] : reference) {
+        EXPECT_EQ(treap.nth(i++)->first, key);
+    }
+    EXPECT_FALSE(treap.nth(i).has_value());
+}
+
+// cvm_update muss bei gleichen Prioritäten genau dasselbe Ergebnis liefern wie die einzelnen Operationen
+// delete_elem, top, pop und insert, wie sie der Knuth-CVM-Algorithmus ursprünglich verwendet hat.
+template<class TreapType>
+static auto check_cvm_update_matches_composed() -> void
+{
+    TreapType fused(64);
+    TreapType composed(64);
+    double p_fused = 1;
+    double p_composed = 1;
+    const std::size_t s = 50;
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<std::uint32_t> dist(0, 200);
+
+    for(int i = 0; i < 20000; i++) {
+        const auto x = dist(gen);
+        const auto u = TreapType::generate_prio();
+
+        p_fused = fused.cvm_update(x, u, p_fused, s);
+
+        composed.delete_elem(x);
+        if(u < p_composed) {
+            if(composed.size() < s) {
+                composed.insert(x, u);
+            } else if(const auto [a, u_prime] = composed.top().value(); u >= u_prime) {
+                p_composed = u;
+            } else {
+                composed.pop();
+                composed.insert(x, u);
+                p_composed = u_prime;
+            }
+        }
+
+        ASSERT_EQ(p_fused, p_composed);
+        ASSERT_EQ(fused.size(), composed.size());
+        ASSERT_EQ(fused.top(), composed.top());
+        ASSERT_EQ(fused.contains(x), composed.contains(x));
+    }
+
+    // Beide Treaps enthalten dieselben Elemente in derselben Heap-Reihenfolge.
+    while(!composed.empty()) {
+        ASSERT_EQ(fused.pop(), composed.pop());
+    }
+    EXPECT_TRUE(fused.empty());
+}
+
+TEST(TreapTests, CvmUpdateMatchesComposedOperations)
+{
+    check_cvm_update_matches_composed<Treap<std::uint32_t>>();
+    check_cvm_update_matches_composed<Treap<std::uint32_t, double, cvm::IndexArena>>();
+    check_cvm_update_matches_composed<Treap<std::uint32_t, double, cvm::SlabArena, true>>();
+}
+
+// for_each besucht alle Elemente in aufsteigender Reihenfolge der Schlüssel mit ihren Prioritäten.
+TEST(TreapTests, ForEachVisitsInKeyOrder)
+{
+    Treap<int> treap;
+    std::map<int, double> reference;
+    std::mt19937 gen(3);
+    for(int i = 0; i < 1000; i++) {
+        const int key = static_cast<int>(gen() % 500);
+        const double prio = std::uniform_real_distribution<double>(0, 1)(gen);
+        if(treap.insert(key, prio)) {
+            reference.emplace(key, prio);
+        }
+    }
+
+    auto it = reference.begin();
+    treap.for_each([&](int key, double prio) {
+        ASSERT_NE(it, reference.end());
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(prio, it->second);
+        ++it;
+    });
+    EXPECT_EQ(it, reference.end());
+}
+
+// Hat jeder Schlüssel eine feste Priorität, liefert cvm_update_fixed denselben Zustand wie cvm_update.
+TEST(TreapTests, CvmUpdateFixedMatchesCvmUpdate)
+{
+    const auto prio_of = [](int key) { return static_cast<double>((key * 2654435761u) % 1000003) / 1000003.0; };
+
+    for(const std::size_t s : {1, 10, 100}) {
+        Treap<int> a;
+        Treap<int> b;
+        double pa = 1;
+        double pb = 1;
+        std::mt19937 gen(static_cast<unsigned>(s));
+        for(int i = 0; i < 20000; i++) {
+            const int key = static_cast<int>(gen() % 2000);
+            pa = a.cvm_update(key, prio_of(key), pa, s);
+            pb = b.cvm_update_fixed(key, prio_of(key), pb, s);
+            ASSERT_EQ(pa, pb);
+            ASSERT_EQ(a.size(), b.size());
+        }
+
+        std::vector<std::pair<int, double>> ea;
+        std::vector<std::pair<int, double>> eb;
+        a.for_each([&](int k, double p) { ea.emplace_back(k, p); });
+        b.for_each([&](int k, double p) { eb.emplace_back(k, p); });
+        EXPECT_EQ(ea, eb);
+    }
+}
+
+// assign_sorted baut aus einer sortierten Folge denselben Treap, den einzelne Einfügungen ergeben hätten:
+// Bei verschiedenen Prioritäten ist der Treap eindeutig, also stimmen Pop-Reihenfolge und Ordnungsstatistiken überein.
+TEST(TreapTests, AssignSortedMatchesInserts)
+{
+    std::map<int, double> reference;
+    std::mt19937 gen(4);
+    while(reference.size() < 2000) {
+        reference.emplace(static_cast<int>(gen() % 100000), std::uniform_real_distribution<double>(0, 1)(gen));
+    }
+    const std::vector<std::pair<int, double>> items(reference.begin(), reference.end());
+
+    Treap<int, double, cvm::SlabArena, true> built;
+    built.insert(-1, 0.5); // Wird ersetzt.
+    built.assign_sorted(items);
+    ASSERT_EQ(built.size(), items.size());
+    for(std::size_t i = 0; i < items.size(); i += 97) {
+        EXPECT_EQ(built.nth(i)->first, items[i].first);
+    }
+
+    Treap<int, double, cvm::IndexArena> inserted;
+    Treap<int, double, cvm::IndexArena> sorted;
+    for(const auto& [key, prio] : items) {
+        inserted.insert(key, prio);
+    }
+    sorted.assign_sorted(items);
+    while(!inserted.empty()) {
+        EXPECT_EQ(sorted.pop(), inserted.pop());
+    }
+    EXPECT_TRUE(sorted.empty());
+}
+
+// Die Iteratoren besuchen dieselben Elemente in derselben Reihenfolge wie for_each.
+TEST(TreapTests, IteratorsVisitInKeyOrder)
+{
+    static_assert(std::forward_iterator<Treap<int>::const_iterator>);
+
+    std::vector<std::pair<int, double>> items;
+    for(int i = 0; i < 500; i++) {
+        items.emplace_back(3 * i, static_cast<double>((i * 7919) % 500) / 500.0);
+    }
+    const Treap<int> treap(items);
+    EXPECT_EQ(treap.size(), items.size());
+
+    std::size_t i = 0;
+    for(const auto& entry : treap) {
+        ASSERT_LT(i, items.size());
+        EXPECT_EQ(entry.elem, items[i].first);
+        EXPECT_EQ(entry.prio, items[i].second);
+        i++;
+    }
+    EXPECT_EQ(i, items.size());
+    EXPECT_EQ(std::distance(treap.begin(), treap.end()), 500);
+    EXPECT_EQ(Treap<int>().begin(), Treap<int>().end());
+}
+
+// Ein zur Liste entarteter Treap (Tiefe n) lässt sich ohne Rekursion kopieren, iterieren und zerstören.
+TEST(TreapTests, CopyOfDegenerateTreap)
+{
+    constexpr int n = 1000000;
+    std::vector<std::pair<int, double>> items;
+    for(int i = 0; i < n; i++) {
+        items.emplace_back(i, 1.0 - static_cast<double>(i) / n);
+    }
+    const Treap<int, double, cvm::IndexArena> treap(items);
+
+    const auto copy = treap;
+    EXPECT_EQ(copy.size(), treap.size());
+    // Die Kopie muss die Prioritäten bitgenau übernehmen.
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), treap.begin(), treap.end(), [](const auto& a, const auto& b) {
+        return a.elem == b.elem && std::bit_cast<std::uint64_t>(a.prio) == std::bit_cast<std::uint64_t>(b.prio);
+    }));
+    EXPECT_EQ(copy.top(), treap.top());
+}
+
+// Prüft Vereinigung, Schnittmenge und Differenz gegen std::map, sequentiell und mit Threads.
+// Nach jeder Operation muss der Treap ein gültiger Treap sein: Schlüssel sortiert, Pop liefert absteigende Prioritäten.
+template<class TreapType>
+static auto check_set_operations(std::size_t n, std::size_t threads) -> void
+{
+    std::mt19937 gen(static_cast<unsigned>(n + threads));
+    std::uniform_real_distribution<double> dist(0, 1);
+    std::map<int, double> ma;
+    std::map<int, double> mb;
+    TreapType a;
+    TreapType b;
+    for(std::size_t i = 0; i < n; i++) {
+        const auto ka = static_cast<int>(gen() % (2 * n));
+        const auto kb = static_cast<int>(gen() % (2 * n));
+        const auto pa = dist(gen);
+        const auto pb = dist(gen);
+        if(a.insert(ka, pa)) {
+            ma.emplace(ka, pa);
+        }
+        if(i % 3 == 0 && b.insert(kb, pb)) {
+            mb.emplace(kb, pb);
+        }
+    }
+
+    const auto check = [](TreapType treap, const std::map<int, double>& expected) {
+        ASSERT_EQ(treap.size(), expected.size());
+        std::vector<std::pair<int, double>> entries;
+        for(const auto& entry : treap) {
+            entries.emplace_back(entry.elem, entry.prio);
+        }
+        const std::vector<std::pair<int, double>> wanted(expected.begin(), expected.end());
+        EXPECT_EQ(entries, wanted);
+
+        if constexpr(requires { treap.nth(0); }) {
+            for(std::size_t i = 0; i < entries.size(); i += 101) {
+                EXPECT_EQ(treap.nth(i)->first, entries[i].first);
+            }
+        }
+
+        auto last = 2.0;
+        while(const auto top = treap.pop()) {
+            EXPECT_LE(top->second, last);
+            last = top->second;
+        }
+    };
+
+    auto united = ma;
+    for(const auto& [key, prio] : mb) {
+        united[key] = prio; // Bei gleichen Schlüsseln gewinnt b.
+    }
+    std::map<int, double> common;
+    std::map<int, double> rest = ma;
+    for(const auto& [key, prio] : ma) {
+        if(mb.contains(key)) {
+            common.emplace(key, prio);
+            rest.erase(key);
+        }
+    }
+
+    auto u = a;
+    u.unite(b, threads);
+    check(u, united);
+
+    auto i = a;
+    i.intersect(b, threads);
+    check(i, common);
+
+    auto d = a;
+    d.subtract(b, threads);
+    check(d, rest);
+
+    // Mit sich selbst oder einem leeren Treap.
+    auto self = a;
+    self.intersect(a, threads);
+    check(self, ma);
+    self.subtract(TreapType(), threads);
+    check(self, ma);
+    self.unite(TreapType(), threads);
+    check(self, ma);
+}
+
+TEST(TreapTests, SetOperationsMatchStdMap)
+{
+    check_set_operations<Treap<int>>(2000, 1);
+    check_set_operations<Treap<int, double, cvm::IndexArena>>(2000, 1);
+    check_set_operations<Treap<int, double, cvm::SlabArena, true>>(2000, 1);
+
+    // Groß genug, dass die obersten Ebenen auf Threads verteilt werden.
+    check_set_operations<Treap<int>>(100000, 4);
+    check_set_operations<Treap<int, double, cvm::IndexArena, true>>(100000, 3);
+}
@@ -0,0 +1,64 @@
+#include <cstddef>
+#include <cstdint>
+#include <cvm/random.hpp>
+#include <cvm/windowed.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Solange alle Elemente des Fensters in einen Puffer passen, zählt der Sketch exakt.
+// Pro Zeiteinheit kommen 10 Nutzer, jeder im Mittel zweimal.
+TEST(WindowedTests, ExactWhileWindowFitsBuffer)
+{
+    cvm::WindowedSketch<std::uint64_t> sketch(100000, 100, 10, cvm::WyRand{1});
+    EXPECT_EQ(sketch.epoch_length(), 10);
+
+    cvm::WyRand rng(2);
+    for(std::uint64_t time = 0; time < 1000; time++) {
+        for(std::uint64_t i = 0; i < 10; i++) {
+            sketch.add(time * 10 + i, time);
+            sketch.add(time * 10 + rng() % 10, time);
+        }
+    }
+
+    // Das Fenster umfasst die aktuelle Epoche 99 und die 10 davor, also die Zeitpunkte 890 bis 999.
+    EXPECT_EQ(sketch.estimate(), 1100);
+
+    // Nach einer ruhigen Phase ist nur noch die letzte Epoche im Fenster, danach keine mehr.
+    sketch.advance(1099);
+    EXPECT_EQ(sketch.estimate(), 100);
+    sketch.advance(1100);
+    EXPECT_EQ(sketch.estimate(), 0);
+
+    // Elemente, deren Epoche schon aus dem Ring gefallen ist, werden verworfen.
+    sketch.add(1, 999);
+    EXPECT_EQ(sketch.estimate(), 0);
+    EXPECT_LE(sketch.size(), 1100);
+}
+
+// Im Stichprobenbereich entspricht das Ergebnis einem einzelnen Sketch über die Elemente des Fensters.
+TEST(WindowedTests, MatchesSketchOverWindow)
+{
+    const std::size_t s = 2000;
+    const std::uint64_t per_tick = 1000;
+    cvm::WindowedSketch<std::uint64_t> sketch(s, 50, 5, cvm::WyRand{3});
+
+    for(std::uint64_t time = 0; time < 200; time++) {
+        std::vector<std::uint64_t> block(per_tick);
+        for(std::uint64_t i = 0; i < per_tick; i++) {
+            // Jeder Nutzer ist etwa 20 Zeiteinheiten aktiv.
+            block[i] = (time + i % 20) * per_tick / 20 + i / 20;
+        }
+        sketch.add_batch(block, time);
+    }
+
+    // Das Fenster umfasst die Zeitpunkte 140 bis 199 (Epochen 14 bis 19).
+    auto expected = sketch.window_sketch().empty_copy();
+    for(std::uint64_t time = 140; time < 200; time++) {
+        for(std::uint64_t i = 0; i < per_tick; i++) {
+            expected.add((time + i % 20) * per_tick / 20 + i / 20);
+        }
+    }
+    const auto window = sketch.window_sketch();
+    EXPECT_EQ(window.estimate(), expected.estimate());
+    EXPECT_EQ(window.size(), s);
+}
@@ -0,0 +1,455 @@
+// cvm_count: Schätzt die Anzahl verschiedener Datensätze in Dateien oder auf stdin mit dem CVM-Algorithmus.
+//
+//   cvm_count [Optionen] [Datei ...]      ohne Datei oder mit '-' wird stdin gelesen
+//
+//   --format text|u8|u16|u32|u64   Zeilen (Standard) oder Binärdatensätze fester Breite in nativer Byte-Reihenfolge
+//   --algo knuth|naive             Knuth Version mit Puffergröße s (Standard) oder naive Version mit epsilon/delta
+//   --s N                          Puffergröße der Knuth Version (Standard 10000)
+//   --epsilon E --delta D          Genauigkeit der naiven Version (Standard 0.1 und 0.01)
+//   --threads T                    Anzahl der Threads, 0 = alle Kerne (Standard 1)
+//   --seed S                       Seed für reproduzierbare Ergebnisse (Standard zufällig)
+//
+// Dateien werden per mmap eingeblendet und ohne Kopie gelesen, stdin blockweise in einen festen Puffer.
+// Zeilen werden zu 64-Bit-Fingerabdrücken gehasht (siehe HashedSketch), Binärdatensätze direkt gezählt.
+// u8 und u16 werden unabhängig von --algo exakt in einer Bitmap gezählt (siehe BitmapCounter), in einem Thread.
+// Ausgegeben werden die Schätzung und der Durchsatz in Datensätzen und Bytes pro Sekunde.
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+#include <cvm/bitmap.hpp>
+#include <cvm/cvm_knuth.hpp>
+#include <cvm/cvm_naive.hpp>
+#include <cvm/hash.hpp>
+#include <cvm/mapped_file.hpp>
+#include <cvm/parallel.hpp>
+#include <cvm/random.hpp>
+
+namespace {
+
+enum class Format { text, u8, u16, u32, u64 };
+enum class Algorithm { knuth, naive };
+
+struct Options
+{
+    Format format = Format::text;
+    Algorithm algo = Algorithm::knuth;
+    std::size_t s = 10000;
+    double epsilon = 0.1;
+    double delta = 0.01;
+    std::size_t threads = 1;
+    std::uint64_t seed = cvm::random_seed();
+    std::vector<std::string> inputs;
+};
+
+// Größe des Lesepuffers für stdin.
+constexpr std::size_t read_buffer_size = std::size_t{1} << 20;
+
+// Anzahl der Datensätze, die auf einmal an die Sketches gehen. Mit mehreren Threads werden größere Blöcke gesammelt,
+// damit sich das Verteilen auf die Threads lohnt.
+constexpr std::size_t batch_size = std::size_t{1} << 12;
+constexpr std::size_t parallel_batch_size = std::size_t{1} << 22;
+
+auto usage() -> int
+{
+    std::fputs("usage: cvm_count [--format text|u8|u16|u32|u64] [--algo knuth|naive] [--s N]\n"
+               "                 [--epsilon E] [--delta D] [--threads T] [--seed S] [file ...]\n",
+               stderr);
+    return 2;
+}
+
+template<class T>
+auto parse_number(std::string_view text) -> std::optional<T>
+{
+    T value{};
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    // clang-format off
+    if(ec != std::errc{} || ptr != text.data() + text.size()) return std::nullopt;
+    // clang-format on
+    return value;
+}
+
+auto parse_options(int argc, char** argv) -> std::optional<Options>
+{
+    Options opts;
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if(!arg.starts_with("--")) {
+            opts.inputs.emplace_back(arg);
+            continue;
+        }
+        // clang-format off
+        if(i + 1 >= argc) return std::nullopt;
+        // clang-format on
+        const std::string_view value = argv[++i];
+
+        if(arg == "--format") {
+            constexpr std::array names = {"text", "u8", "u16", "u32", "u64"};
+            const auto it = std::find(names.begin(), names.end(), value);
+            // clang-format off
+            if(it == names.end()) return std::nullopt;
+            // clang-format on
+            opts.format = static_cast<Format>(it - names.begin());
+        } else if(arg == "--algo") {
+            // clang-format off
+            if(value != "knuth" && value != "naive") return std::nullopt;
+            // clang-format on
+            opts.algo = value == "knuth" ? Algorithm::knuth : Algorithm::naive;
+        } else if(arg == "--epsilon" || arg == "--delta") {
+            const auto number = parse_number<double>(value);
+            // clang-format off
+            if(!number) return std::nullopt;
+            // clang-format on
+            (arg == "--epsilon" ? opts.epsilon : opts.delta) = *number;
+        } else {
+            const auto number = parse_number<std::uint64_t>(value);
+            // clang-format off
+            if(!number) return std::nullopt;
+            if(arg == "--s") opts.s = *number;
+            else if(arg == "--threads") opts.threads = *number;
+            else if(arg == "--seed") opts.seed = *number;
+            else return std::nullopt;
+            // clang-format on
+        }
+    }
+
+    if(opts.inputs.empty()) {
+        opts.inputs.emplace_back("-");
+    }
+    if(opts.threads == 0) {
+        opts.threads = cvm::default_threads();
+    }
+    // clang-format off
+    if(opts.s == 0 || !(opts.epsilon > 0) || !(opts.delta > 0 && opts.delta < 1)) return std::nullopt;
+    // clang-format on
+    return opts;
+}
+
+// Hält pro Thread einen Sketch über Schlüssel vom Typ K und verteilt jeden Block auf die Threads.
+template<class K>
+class Counter
+{
+    using Knuth = cvm::KnuthSketch<K>;
+    using Naive = cvm::NaiveSketch<K>;
+
+public:
+    // 'length' ist die Anzahl der Datensätze, falls bekannt. Sonst verwendet die naive Version den Verdopplungsplan.
+    Counter(const Options& opts, std::optional<std::size_t> length)
+    {
+        auto seed = opts.seed;
+        for(std::size_t t = 0; t < opts.threads; t++) {
+            const cvm::WyRand rng(cvm::splitmix64(seed));
+            if(opts.algo == Algorithm::knuth) {
+                knuth_.emplace_back(opts.s, rng);
+            } else if(length) {
+                naive_.emplace_back(opts.epsilon, opts.delta, *length, rng);
+            } else {
+                naive_.emplace_back(opts.epsilon, opts.delta, rng);
+            }
+        }
+    }
+
+    auto add_batch(std::span<const K> block) -> void
+    {
+        items_ += block.size();
+        if(!knuth_.empty()) {
+            add_to(std::span<Knuth>(knuth_), block);
+        } else {
+            add_to(std::span<Naive>(naive_), block);
+        }
+    }
+
+    // Vereinigt die Sketches der Threads und gibt die Schätzung zurück (std::nullopt, wenn die naive Version scheitert).
+    auto estimate() -> std::optional<double>
+    {
+        if(!knuth_.empty()) {
+            for(std::size_t t = 1; t < knuth_.size(); t++) {
+                knuth_[0].merge(knuth_[t]);
+            }
+            return knuth_[0].estimate();
+        }
+
+        for(std::size_t t = 1; t < naive_.size(); t++) {
+            // clang-format off
+            if(!naive_[0].merge(naive_[t])) return std::nullopt;
+            // clang-format on
+        }
+        return naive_[0].estimate();
+    }
+
+    [[nodiscard]] auto items() const -> std::size_t
+    {
+        return items_;
+    }
+
+    [[nodiscard]] auto threads() const -> std::size_t
+    {
+        return std::max(knuth_.size(), naive_.size());
+    }
+
+private:
+    template<class Sketch>
+    static auto add_to(std::span<Sketch> sketches, std::span<const K> block) -> void
+    {
+        if(sketches.size() == 1) {
+            static_cast<void>(sketches[0].add_batch(block));
+        } else {
+            cvm::parallel_add_batch(block.begin(), block.end(), sketches);
+        }
+    }
+
+    std::vector<Knuth> knuth_;
+    std::vector<Naive> naive_;
+    std::size_t items_ = 0;
+};
+
+// Zählt schmale Schlüssel exakt mit derselben Schnittstelle wie Counter. Ein Thread genügt, weil pro Element nur ein
+// Bit gesetzt wird. Sobald jeder Wert vorkam, werden weitere Blöcke nur noch mitgezählt.
+template<class K>
+class ExactCounter
+{
+public:
+    ExactCounter(const Options& /*opts*/, std::optional<std::size_t> /*length*/) {}
+
+    auto add_batch(std::span<const K> block) -> void
+    {
+        items_ += block.size();
+        if(!bitmap_.full()) {
+            bitmap_.add_batch(block);
+        }
+    }
+
+    auto estimate() -> std::optional<double>
+    {
+        return bitmap_.estimate();
+    }
+
+    [[nodiscard]] auto items() const -> std::size_t
+    {
+        return items_;
+    }
+
+    [[nodiscard]] auto threads() const -> std::size_t
+    {
+        return 1;
+    }
+
+private:
+    cvm::BitmapCounter<K> bitmap_;
+    std::size_t items_ = 0;
+};
+
+// Zähler für Schlüssel vom Typ K: exakt für schmale Schlüssel, sonst mit den Sketches.
+template<class K>
+using CounterFor = std::conditional_t<cvm::NarrowKey<K>, ExactCounter<K>, Counter<K>>;
+
+// Liest höchstens 'size' Bytes von stdin nach 'data'. Gibt die Anzahl der gelesenen Bytes zurück, 0 am Ende.
+auto read_stdin(char* data, std::size_t size) -> std::size_t
+{
+    while(true) {
+        const auto got = ::read(STDIN_FILENO, data, size);
+        // clang-format off
+        if(got >= 0) return static_cast<std::size_t>(got);
+        if(errno != EINTR) return 0;
+        // clang-format on
+    }
+}
+
+// Ergebnis eines Durchlaufs über alle Eingaben.
+struct Result
+{
+    std::optional<double> estimate; // std::nullopt, wenn die naive Version scheitert.
+    std::size_t items = 0;
+    std::size_t bytes = 0;
+};
+
+// Zerlegt 'bytes' in Zeilen, hasht sie und reicht die Fingerabdrücke blockweise weiter. Gibt die Anzahl der
+// verbrauchten Bytes zurück. Ist 'last' false, bleibt eine unvollständige letzte Zeile für den nächsten Aufruf übrig.
+auto add_lines(Counter<std::uint64_t>& counter, std::vector<std::uint64_t>& hashes, std::string_view bytes, bool last)
+    -> std::size_t
+{
+    const auto block = counter.threads() > 1 ? parallel_batch_size : batch_size;
+
+    std::size_t pos = 0;
+    while(pos < bytes.size()) {
+        const auto newline = bytes.find('\n', pos);
+        // clang-format off
+        if(newline == std::string_view::npos && !last) break;
+        // clang-format on
+
+        const auto end = newline == std::string_view::npos ? bytes.size() : newline;
+        auto line = bytes.substr(pos, end - pos);
+        if(line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        hashes.push_back(cvm::Hash<std::string_view>{}(line));
+        pos = newline == std::string_view::npos ? bytes.size() : newline + 1;
+
+        if(hashes.size() >= block) {
+            counter.add_batch(hashes);
+            hashes.clear();
+        }
+    }
+
+    return pos;
+}
+
+// Zählt Zeilen aus allen Eingaben. Gibt false zurück, wenn eine Datei nicht gelesen werden kann.
+auto count_text(const Options& opts, Result& result) -> bool
+{
+    Counter<std::uint64_t> counter(opts, std::nullopt);
+    std::vector<std::uint64_t> hashes;
+    std::vector<char> buffer;
+
+    for(const auto& input : opts.inputs) {
+        if(input != "-") {
+            const auto file = cvm::MappedRecords<char>::open(input);
+            if(!file) {
+                std::fprintf(stderr, "cvm_count: cannot read %s\n", input.c_str());
+                return false;
+            }
+            result.bytes += file->size();
+            add_lines(counter, hashes, {file->data(), file->size()}, true);
+            continue;
+        }
+
+        // stdin: Eine unvollständige Zeile am Ende des Puffers wird an den Anfang verschoben und weitergelesen.
+        buffer.resize(read_buffer_size);
+        std::size_t filled = 0;
+        while(true) {
+            const auto got = read_stdin(buffer.data() + filled, buffer.size() - filled);
+            result.bytes += got;
+            filled += got;
+
+            const auto used = add_lines(counter, hashes, {buffer.data(), filled}, got == 0);
+            std::memmove(buffer.data(), buffer.data() + used, filled - used);
+            filled -= used;
+
+            // clang-format off
+            if(got == 0) break;
+            // clang-format on
+            if(filled == buffer.size()) {
+                buffer.resize(2 * buffer.size()); // Zeile länger als der Puffer.
+            }
+        }
+    }
+
+    counter.add_batch(hashes);
+    result.items = counter.items();
+    result.estimate = counter.estimate();
+    return true;
+}
+
+// Zählt Binärdatensätze vom Typ T aus allen Eingaben. Gibt false zurück, wenn eine Datei nicht gelesen werden kann.
+template<class T>
+auto count_binary(const Options& opts, Result& result) -> bool
+{
+    // Dateien werden zuerst alle eingeblendet, damit die naive Version die Gesamtlänge kennt.
+    std::vector<std::optional<cvm::MappedRecords<T>>> files;
+    std::optional<std::size_t> length = 0;
+    for(const auto& input : opts.inputs) {
+        if(input == "-") {
+            files.emplace_back(std::nullopt);
+            length.reset();
+            continue;
+        }
+
+        auto file = cvm::MappedRecords<T>::open(input);
+        if(!file) {
+            std::fprintf(stderr, "cvm_count: cannot read %s\n", input.c_str());
+            return false;
+        }
+        if(length) {
+            *length += file->size();
+        }
+        files.push_back(std::move(file));
+    }
+
+    CounterFor<T> counter(opts, length);
+    std::vector<T> records;
+    for(const auto& file : files) {
+        // Eingeblendete Dateien gehen blockweise an die Sketches, damit parallel_add_batch beim Verteilen nur einen
+        // Block und nicht die ganze Datei kopiert.
+        if(file) {
+            result.bytes += file->size() * sizeof(T);
+            const auto all = file->records();
+            const auto block = counter.threads() > 1 ? parallel_batch_size : batch_size;
+            for(std::size_t offset = 0; offset < all.size(); offset += block) {
+                counter.add_batch(all.subspan(offset, std::min(block, all.size() - offset)));
+            }
+            continue;
+        }
+
+        // stdin wird direkt in einen Puffer aus Datensätzen gelesen. Bytes, die noch keinen ganzen Datensatz
+        // ergeben, wandern an den Anfang und werden beim nächsten Lesen ergänzt.
+        records.resize(counter.threads() > 1 ? parallel_batch_size : read_buffer_size / sizeof(T));
+        auto* bytes = reinterpret_cast<char*>(records.data());
+        const auto capacity = records.size() * sizeof(T);
+        std::size_t filled = 0;
+        while(const auto got = read_stdin(bytes + filled, capacity - filled)) {
+            result.bytes += got;
+            filled += got;
+
+            const auto n = filled / sizeof(T);
+            counter.add_batch(std::span<const T>(records.data(), n));
+            std::memmove(bytes, bytes + n * sizeof(T), filled - n * sizeof(T));
+            filled -= n * sizeof(T);
+        }
+    }
+
+    result.items = counter.items();
+    result.estimate = counter.estimate();
+    return true;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    const auto opts = parse_options(argc, argv);
+    // clang-format off
+    if(!opts) return usage();
+    // clang-format on
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Result result;
+    auto ok = false;
+    switch(opts->format) {
+        case Format::text: ok = count_text(*opts, result); break;
+        case Format::u8: ok = count_binary<std::uint8_t>(*opts, result); break;
+        case Format::u16: ok = count_binary<std::uint16_t>(*opts, result); break;
+        case Format::u32: ok = count_binary<std::uint32_t>(*opts, result); break;
+        case Format::u64: ok = count_binary<std::uint64_t>(*opts, result); break;
+    }
+    // clang-format off
+    if(!ok) return 1;
+    // clang-format on
+
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(!result.estimate) {
+        std::fputs("cvm_count: estimation failed (buffer threshold exceeded)\n", stderr);
+        return 1;
+    }
+
+    std::printf("estimate:  %.0f\n", *result.estimate);
+    std::printf("items:     %zu\n", result.items);
+    std::printf("bytes:     %zu\n", result.bytes);
+    std::printf("seconds:   %.3f\n", seconds);
+    std::printf("items/s:   %.0f\n", seconds > 0 ? static_cast<double>(result.items) / seconds : 0.0);
+    std::printf("bytes/s:   %.0f\n", seconds > 0 ? static_cast<double>(result.bytes) / seconds : 0.0);
+    return 0;
+}